@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Samples per second of all noise algorithms, evaluated on whole tiles: the 3D
+// libnoise module, the scalar getValue() path and the batched fillHeights()
+// path.
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "defaults.h"
+#include "noise.h"
+
+// number of tiles evaluated per measurement
+static const int Tiles = 64;
+
+// samples per second of fill(xOffset, zOffset, out) over Tiles tiles
+template <typename Fill>
+static double measure(Fill fill) {
+  int width = Defaults::TileWidth + 1;
+  std::vector<float> heights(width * width);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int tile = 0; tile < Tiles; tile++) {
+    fill(tile * Defaults::TileWidth, -tile * Defaults::TileWidth,
+         &heights.front());
+  }
+  std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start;
+  return Tiles * width * width / seconds.count();
+}
+
+// samples per second of module, called like getValue() did before the 2D
+// kernels
+static double measureLibnoise(const noise::module::Module &module) {
+  int width = Defaults::TileWidth + 1;
+  return measure([&](int x, int z, float *out) {
+    for (int row = 0; row < width; row++) {
+      for (int column = 0; column < width; column++) {
+        out[row * width + column] = module.GetValue(
+            static_cast<float>(x + column) / Defaults::Resolution, 0.0,
+            static_cast<float>(z + row) / Defaults::Resolution);
+      }
+    }
+  });
+}
+
+static void run(const char *name, const NoiseInterface &noise,
+                double libnoise) {
+  int width = Defaults::TileWidth + 1;
+
+  double scalar = measure([&](int x, int z, float *out) {
+    noise.NoiseInterface::fillHeights(x, z, width, width, width, out);
+  });
+  double batch = measure([&](int x, int z, float *out) {
+    noise.fillHeights(x, z, width, width, width, out);
+  });
+
+  std::printf("%-12s %14.0f %14.0f %14.0f %8.2fx\n", name, libnoise, scalar,
+              batch, batch / libnoise);
+}
+
+int main() {
+  std::printf("%-12s %14s %14s %14s %9s\n", "algorithm", "libnoise [1/s]",
+              "scalar [1/s]", "batch [1/s]", "speedup");
+
+  PerlinNoise perlin;
+  run("Perlin", perlin, measureLibnoise(noise::module::Perlin()));
+  RidgedMultiNoise ridgedMulti;
+  run("RidgedMulti", ridgedMulti,
+      measureLibnoise(noise::module::RidgedMulti()));
+  BillowNoise billow;
+  run("Billow", billow, measureLibnoise(noise::module::Billow()));
+  // there is no libnoise module for random noise, compare with scalar path
+  RandomNoise random;
+  int width = Defaults::TileWidth + 1;
+  run("Random", random, measure([&](int x, int z, float *out) {
+        random.NoiseInterface::fillHeights(x, z, width, width, width, out);
+      }));
+
+  // the same modules chained with libnoise. Its turbulence is 3D, so values
+  // differ slightly, but work per sample is comparable
+  MountainNoise mountains;
+  noise::module::RidgedMulti mountainTerrain;
+  noise::module::Billow baseFlatTerrain;
+  baseFlatTerrain.SetFrequency(2.0);
+  noise::module::ScaleBias flatTerrain;
+  flatTerrain.SetSourceModule(0, baseFlatTerrain);
+  flatTerrain.SetScale(0.125);
+  flatTerrain.SetBias(-0.75);
+  noise::module::Perlin terrainType;
+  terrainType.SetFrequency(0.5);
+  terrainType.SetPersistence(0.25);
+  terrainType.SetSeed(1);
+  noise::module::Select terrainSelector;
+  terrainSelector.SetSourceModule(0, flatTerrain);
+  terrainSelector.SetSourceModule(1, mountainTerrain);
+  terrainSelector.SetControlModule(terrainType);
+  terrainSelector.SetBounds(0.0, 1000.0);
+  terrainSelector.SetEdgeFalloff(0.125);
+  noise::module::Turbulence finalTerrain;
+  finalTerrain.SetSourceModule(0, terrainSelector);
+  finalTerrain.SetFrequency(4.0);
+  finalTerrain.SetPower(0.125);
+  run("Mountains", mountains, measureLibnoise(finalTerrain));
+
+  return 0;
+}
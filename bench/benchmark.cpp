@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#include "arguments.h"
+
+namespace {
+
+// iteration count of a batch never exceeds this
+const int64_t MaximumIterations = 1000000000;
+
+// CPU time of the calling thread in seconds, like cpu_time of Google
+// Benchmark. Time spent by other threads, e.g. workers of a thread pool, is
+// not included
+double threadCpuSeconds() {
+#ifdef _WIN32
+  // whole process, there is no portable per-thread clock
+  return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#else
+  timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+}
+
+// name with quotes and backslashes escaped for JSON and CSV
+std::string quoted(const std::string &name) {
+  std::string result = "\"";
+  for (char c : name) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result + "\"";
+}
+
+} // namespace
+
+Benchmark::Benchmark() : format_(Console), minTime_(0.5) {
+}
+
+void Benchmark::add(const std::string &name, const Body &body) {
+  entries_.push_back(Entry{name, body});
+}
+
+bool Benchmark::parseArguments(const int &argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    const char *value;
+    if ((value = Arguments::getValue(argv[i], "--benchmark_filter"))) {
+      filter_ = value;
+    } else if ((value =
+                    Arguments::getValue(argv[i], "--benchmark_min_time"))) {
+      if (!Arguments::parseNumber(value, minTime_) || minTime_ < 0.0) {
+        std::cerr << "Error: invalid minimum time " << value << std::endl;
+        return false;
+      }
+    } else if ((value =
+                    Arguments::getValue(argv[i], "--benchmark_format"))) {
+      if (std::strcmp(value, "console") == 0) {
+        format_ = Console;
+      } else if (std::strcmp(value, "csv") == 0) {
+        format_ = Csv;
+      } else if (std::strcmp(value, "json") == 0) {
+        format_ = Json;
+      } else {
+        std::cerr << "Error: unknown format " << value << std::endl;
+        return false;
+      }
+    } else {
+      std::cerr << "Error: unknown argument " << argv[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<Benchmark::Result> Benchmark::run(std::ostream &out) {
+  std::vector<Result> results;
+  writeHeader(format_, out);
+  for (const Entry &entry : entries_) {
+    if (entry.name.find(filter_) == std::string::npos) {
+      continue;
+    }
+    Result result = measure(entry);
+    write(format_, result, results.empty(), out);
+    results.push_back(result);
+  }
+  writeFooter(format_, out);
+  return results;
+}
+
+Benchmark::Result Benchmark::measure(const Entry &entry) {
+  // first iteration warms up caches and lazily created data
+  entry.body();
+
+  int64_t iterations = 1;
+  while (true) {
+    size_t items = 0;
+    double cpuStart = threadCpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < iterations; i++) {
+      items += entry.body();
+    }
+    std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - start;
+    double cpuSeconds = threadCpuSeconds() - cpuStart;
+
+    if (seconds.count() >= minTime_ || iterations >= MaximumIterations) {
+      Result result;
+      result.name = entry.name;
+      result.iterations = iterations;
+      result.realTime = seconds.count() * 1e9 / iterations;
+      result.cpuTime = cpuSeconds * 1e9 / iterations;
+      result.itemsPerSecond = items / seconds.count();
+      return result;
+    }
+
+    // aim a bit above minimum time, but grow at most tenfold per batch as
+    // short batches are inaccurate
+    double factor = seconds.count() > 0.0
+                        ? 1.4 * minTime_ / seconds.count()
+                        : 10.0;
+    factor = std::min(std::max(factor, 2.0), 10.0);
+    iterations = std::min(static_cast<int64_t>(iterations * factor),
+                          MaximumIterations);
+  }
+}
+
+void Benchmark::writeHeader(const Format &format, std::ostream &out) {
+  char line[256];
+  switch (format) {
+  case Console:
+    std::snprintf(line, sizeof(line), "%-44s %14s %14s %12s %16s\n",
+                  "Benchmark", "Time [ns]", "CPU [ns]", "Iterations",
+                  "Items [1/s]");
+    out << line << std::string(104, '-') << "\n";
+    break;
+  case Csv:
+    out << "name,iterations,real_time,cpu_time,time_unit,items_per_second\n";
+    break;
+  case Json: {
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S",
+                  std::localtime(&now));
+    out << "{\n  \"context\": {\n    \"date\": \"" << date << "\",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency()
+        << "\n  },\n  \"benchmarks\": [";
+    break;
+  }
+  }
+}
+
+void Benchmark::write(const Format &format, const Result &result,
+                      const bool &first, std::ostream &out) {
+  char line[512];
+  switch (format) {
+  case Console:
+    std::snprintf(line, sizeof(line), "%-44s %14.0f %14.0f %12lld %16.0f\n",
+                  result.name.c_str(), result.realTime, result.cpuTime,
+                  static_cast<long long>(result.iterations),
+                  result.itemsPerSecond);
+    out << line;
+    break;
+  case Csv:
+    std::snprintf(line, sizeof(line), ",%lld,%f,%f,ns,%f\n",
+                  static_cast<long long>(result.iterations), result.realTime,
+                  result.cpuTime, result.itemsPerSecond);
+    out << quoted(result.name) << line;
+    break;
+  case Json:
+    std::snprintf(line, sizeof(line),
+                  ",\n      \"iterations\": %lld,\n"
+                  "      \"real_time\": %f,\n      \"cpu_time\": %f,\n"
+                  "      \"time_unit\": \"ns\",\n"
+                  "      \"items_per_second\": %f\n    }",
+                  static_cast<long long>(result.iterations), result.realTime,
+                  result.cpuTime, result.itemsPerSecond);
+    out << (first ? "\n" : ",\n") << "    {\n      \"name\": "
+        << quoted(result.name) << line;
+    break;
+  }
+  out.flush();
+}
+
+void Benchmark::writeFooter(const Format &format, std::ostream &out) {
+  if (format == Json) {
+    out << "\n  ]\n}\n";
+  }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Minimal runner for microbenchmarks, modelled after Google Benchmark. Each
+// benchmark is repeated with growing iteration counts until a batch takes at
+// least the minimum time. Results of the last batch are reported as console
+// table, CSV or JSON with the field names of Google Benchmark, so results of
+// different versions can be compared with the usual tools.
+class Benchmark {
+ public:
+  // one iteration of a benchmark, returns number of processed items, e.g.
+  // samples or vertices
+  typedef std::function<size_t()> Body;
+
+  enum Format { Console, Csv, Json };
+
+  struct Result {
+    std::string name;
+    int64_t iterations;
+    // per iteration, in nanoseconds. Cpu time is that of the thread running
+    // the benchmark only, without e.g. workers of a thread pool
+    double realTime;
+    double cpuTime;
+    double itemsPerSecond;
+  };
+
+  Benchmark();
+
+  void add(const std::string &name, const Body &body);
+  // parse --benchmark_filter=<substring>, --benchmark_format=<console|csv|
+  // json> and --benchmark_min_time=<seconds>. Returns false on unknown
+  // arguments
+  bool parseArguments(const int &argc, char **argv);
+  // run benchmarks whose name contains filter and write results to out
+  std::vector<Result> run(std::ostream &out = std::cout);
+
+ private:
+  struct Entry {
+    std::string name;
+    Body body;
+  };
+
+  std::vector<Entry> entries_;
+  std::string filter_;
+  Format format_;
+  double minTime_;
+
+  Result measure(const Entry &entry);
+  static void writeHeader(const Format &format, std::ostream &out);
+  static void write(const Format &format, const Result &result,
+                    const bool &first, std::ostream &out);
+  static void writeFooter(const Format &format, std::ostream &out);
+};
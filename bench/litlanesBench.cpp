@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Microbenchmarks of the generation pipeline: noise, tile generation,
+// vertices, quadtree and tile crossings. Needs no OpenGL context. Run with
+// --benchmark_format=json or csv to track results between versions, see
+// Benchmark::parseArguments()
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "defaults.h"
+#include "noise.h"
+#include "quadtree.h"
+#include "threadPool.h"
+#include "tile.h"
+#include "tileCache.h"
+#include "tileGenerator.h"
+#include "tileGrid.h"
+
+namespace {
+
+const int Width = Defaults::TileWidth + 1;
+
+struct Algorithm {
+  const char *name;
+  int id;
+  // options other than seed matter
+  bool hasOctaves;
+};
+
+const Algorithm Algorithms[] = {{"Perlin", Defaults::Perlin, true},
+                                {"RidgedMulti", Defaults::RidgedMulti, true},
+                                {"Billow", Defaults::Billow, true},
+                                {"Random", Defaults::Random, false},
+                                {"Mountains", Defaults::Mountains, true}};
+
+std::shared_ptr<const NoiseInterface> createNoise(const int &algorithm,
+                                                  const int &octaveCount) {
+  std::shared_ptr<const NoiseInterface> noise =
+      NoiseInterface::create(algorithm);
+  NoiseOptions options = noise->getOptions();
+  options.octaveCount = octaveCount;
+  return noise->withOptions(options);
+}
+
+// samples of a whole tile, each iteration at the next tile eastwards
+Benchmark::Body fillHeights(
+    const std::shared_ptr<const NoiseInterface> &noise) {
+  std::shared_ptr<std::vector<float>> heights(
+      new std::vector<float>(Width * Width));
+  std::shared_ptr<int> tile(new int(0));
+  return [noise, heights, tile]() {
+    noise->fillHeights((*tile)++ * Defaults::TileWidth, 0, Width, Width,
+                       Width, &heights->front());
+    return heights->size();
+  };
+}
+
+// full tile generation without caches, including quadtree bounds
+Benchmark::Body generate(const std::shared_ptr<const NoiseInterface> &noise) {
+  std::shared_ptr<int> tile(new int(0));
+  return [noise, tile]() {
+    TileData data =
+        TileGenerator::generate((*tile)++, 0, noise, Defaults::TileWidth);
+    return data.heights.size();
+  };
+}
+
+// CPU side of TileManager::update() when the camera crosses into the next
+// tile eastwards: the column of tiles leaving the view is requested at the
+// newly exposed column, generated on the thread pool with tile cache,
+// applied and its vertices built, then levels of detail are updated. Tiles
+// have no buffers, so vertices are built as an upload would, but nothing is
+// uploaded
+class Crossing {
+ public:
+  explicit Crossing(const int &viewRadius)
+      : grid_(viewRadius),
+        noise_(NoiseInterface::create(Defaults::Perlin)),
+        pool_(std::thread::hardware_concurrency()) {
+    tiles_.resize(grid_.getSlotCount());
+    for (const TileCoordinates &tile : grid_.getTiles()) {
+      size_t slot = grid_.slot(tile.x, tile.z);
+      tiles_[slot].reset(new Tile(tile.x, tile.z, noise_));
+      tiles_[slot]->setCache(&cache_);
+    }
+  }
+
+  size_t cross() {
+    std::vector<TileCoordinates> exposed =
+        grid_.moveTo(grid_.getCenterX() + 1, grid_.getCenterZ());
+    for (const TileCoordinates &tile : exposed) {
+      tiles_[grid_.slot(tile.x, tile.z)]->requestCoordinates(tile.x, tile.z,
+                                                              pool_);
+    }
+    for (const TileCoordinates &tile : exposed) {
+      Tile &current = *tiles_[grid_.slot(tile.x, tile.z)];
+      current.waitForPendingJob();
+      current.applyFinishedJob();
+      current.getVertices();
+    }
+
+    glm::vec3 position((grid_.getCenterX() + 0.5f) * Defaults::TileWidth,
+                       0.0f, 0.5f * Defaults::TileWidth);
+    for (auto &tile : tiles_) {
+      tile->setLod(Tile::selectLod(tile->distanceTo(position)));
+    }
+    return exposed.size();
+  }
+
+ private:
+  TileGrid grid_;
+  std::shared_ptr<const NoiseInterface> noise_;
+  // declared before pool_, so it outlives running jobs
+  TileCache cache_;
+  ThreadPool pool_;
+  std::vector<std::unique_ptr<Tile>> tiles_;
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Benchmark benchmark;
+  if (!benchmark.parseArguments(argc, argv)) {
+    return 1;
+  }
+
+  // noise samples per algorithm and octave count
+  for (const Algorithm &algorithm : Algorithms) {
+    if (!algorithm.hasOctaves) {
+      benchmark.add(std::string("noise/") + algorithm.name,
+                    fillHeights(NoiseInterface::create(algorithm.id)));
+      continue;
+    }
+    for (int octaveCount : {1, 3, 6}) {
+      benchmark.add(std::string("noise/") + algorithm.name + "/octaves:" +
+                        std::to_string(octaveCount),
+                    fillHeights(createNoise(algorithm.id, octaveCount)));
+    }
+  }
+
+  // whole tiles, vertices per tile
+  for (const Algorithm &algorithm : Algorithms) {
+    benchmark.add(std::string("tile/generate/") + algorithm.name,
+                  generate(NoiseInterface::create(algorithm.id)));
+  }
+  std::shared_ptr<Tile> tile(new Tile(0, 0));
+  benchmark.add("tile/createVertices",
+                [tile]() { return tile->getVertices().size(); });
+
+  // quadtree construction and indices of each level of detail
+  benchmark.add("quadtree/construct", []() {
+    Quadtree quadtree;
+    return Quadtree::getNodeCount();
+  });
+  std::shared_ptr<Quadtree> quadtree(new Quadtree);
+  for (int lod = 0; lod <= Defaults::MaximumLod; lod++) {
+    benchmark.add("quadtree/getIndicesOfLevel/lod:" + std::to_string(lod),
+                  [quadtree, lod]() {
+                    return quadtree->getIndicesOfLevel(lod).size();
+                  });
+  }
+
+  // tile crossings, items are tiles requested per crossing
+  for (int viewRadius : {1, 4, 8}) {
+    std::shared_ptr<Crossing> crossing(new Crossing(viewRadius));
+    benchmark.add("tileManager/crossing/radius:" + std::to_string(viewRadius),
+                  [crossing]() { return crossing->cross(); });
+  }
+
+  benchmark.run();
+  return 0;
+}
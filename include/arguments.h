@@ -0,0 +1,14 @@
+#pragma once
+
+// Command line arguments of the form --name=value, shared by litlanes,
+// litlanesBake and litlanesBench
+namespace Arguments {
+
+// value of argument if it is --name=value for name "--name", or nullptr
+const char *getValue(const char *argument, const char *name);
+
+// whole text is an integer or a number, e.g. "3x" is neither
+bool parseInteger(const char *text, long &value);
+bool parseNumber(const char *text, double &value);
+
+} // namespace Arguments
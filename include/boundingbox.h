@@ -2,17 +2,22 @@
 
 #include <glm/glm.hpp>
 
-// Simplified Axis-Aligned Square Bounding Box (AABB)
+// Axis-Aligned Bounding Box (AABB)
 class BoundingBox {
  public:
   // create square AABB around center edge length of 2*extends
   BoundingBox(glm::vec3 center, float extents);
+  // create AABB spanning from minimum to maximum corner
+  BoundingBox(const glm::vec3 &minimum, const glm::vec3 &maximum);
 
   // True if sphere intersects with bounding box
   bool intersectsWithSphere(const glm::vec3 &spherePosition,
                             const float &sphereRadius);
 
+  const glm::vec3 &getMinimum() const;
+  const glm::vec3 &getMaximum() const;
+
  private:
-  glm::vec3 center_;
-  float extents_;
+  glm::vec3 minimum_;
+  glm::vec3 maximum_;
 };
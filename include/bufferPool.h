@@ -0,0 +1,38 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+// One large vertex buffer split into a fixed number of slots of equal size.
+// Tiles acquire a slot once and update it in place with glBufferSubData, so
+// moving around never allocates new buffers on the GPU.
+class BufferPool {
+ public:
+  BufferPool();
+
+  // allocate buffer of slotCount slots with slotSize bytes each. there must be
+  // an opengl context!
+  void create(const size_t &slotCount, const size_t &slotSize);
+  void cleanup();
+
+  // reserve free slot. Returns -1 if all slots are in use
+  int acquire();
+  void release(const int &slot);
+
+  // copy size bytes of data into slot, starting offset bytes into the slot
+  void update(const int &slot, const GLvoid *data, const size_t &size,
+              const size_t &offset = 0);
+
+  GLuint getBuffer();
+  // offset of first byte of slot in buffer
+  size_t getSlotOffset(const int &slot);
+  size_t getSlotSize();
+  size_t getSlotCount();
+  size_t getFreeCount();
+
+ private:
+  GLuint buffer_;
+  size_t slotSize_;
+  size_t slotCount_;
+  std::vector<int> freeSlots_;
+};
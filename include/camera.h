@@ -21,6 +21,10 @@ class Camera {
   void processKeyboard(CameraMovement direction, GLfloat deltaTime);
   void processMouseMovement(GLfloat xoffset, GLfloat yoffset);
   glm::vec3 getPosition();
+  // place camera, e.g. on a scripted path. Pitch is limited like for mouse
+  // movement
+  void setPose(const glm::vec3 &position, const GLfloat &yaw,
+               const GLfloat &pitch);
   void setMovementSpeed(const GLfloat &speed);
 
  private:
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "noise.h"
+
+// Scripted fly-through for reproducible performance runs. Text with one
+// command per line, "<time> <command> <arguments>", times in seconds and in
+// any order. '#' starts a comment.
+//   0.0 camera <x> <y> <z> <yaw> <pitch>
+//       pose at time, linearly interpolated between poses
+//   5.0 algorithm <perlin|ridgedmulti|billow|random|mountains>
+//   8.0 <frequency|lacunarity|octaves|persistence|seed> <value>
+//       change of terrain algorithm or one of its options. Values out of
+//       range, see NoiseInterface::setOption(), are errors
+class CameraPath {
+ public:
+  struct Pose {
+    double time;
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+  };
+
+  struct Change {
+    double time;
+    // "algorithm" or name of noise option
+    std::string name;
+    // algorithm, see Defaults, or value of option
+    double value;
+  };
+
+  // read path file. Returns false if it can't be read or has errors, which
+  // are reported with their line
+  bool load(const std::string &path);
+  bool parse(std::istream &input);
+
+  // pose at time, first or last pose before or after path. Needs at least
+  // one pose
+  Pose getPose(const double &time) const;
+  // changes with time in [from, to), in order of time
+  std::vector<Change> getChanges(const double &from, const double &to) const;
+  // time of last pose or change
+  double getDuration() const;
+
+  // set option of change in options. Returns false for algorithm changes
+  static bool applyOption(const Change &change, NoiseOptions &options);
+
+ private:
+  std::vector<Pose> poses_;     // sorted by time
+  std::vector<Change> changes_; // sorted by time
+};
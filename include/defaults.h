@@ -1,7 +1,7 @@
 #pragma once
 
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
+#include <cmath>
+#include <cstddef>
 #include <vector>
 #include <glm/glm.hpp>
 
@@ -9,8 +9,19 @@ namespace Defaults {
 // WINDOW
 
 // Window size
-static const GLuint WindowWidth = 1200;
-static const GLuint WindowHeight = 800;
+static const unsigned int WindowWidth = 1200;
+static const unsigned int WindowHeight = 800;
+
+// Number of frames shown in frame time graph and histogram
+static const int FrameTimeHistory = 300;
+
+// Number of frames recorded in a trace of the frame profiler, and the limit
+// of events of a trace
+static const int TraceFrames = 300;
+static const size_t MaximumTraceEvents = 1000000;
+
+// Time between frames when replaying a camera path, in seconds
+static const float ReplayTimestep = 1.0f / 60.0f;
 
 
 // TERRAIN
@@ -20,28 +31,55 @@ static const int Perlin = 0;
 static const int RidgedMulti = 1;
 static const int Billow = 2;
 static const int Random = 3;
+static const int Mountains = 4;
 
 // Default width of terrain tile in triangles. Must be a factor of 2.
-static const GLuint TileWidth = 64;
+static const unsigned int TileWidth = 64;
 
 // Default resolution
-static const GLuint Resolution = 64;
+static const unsigned int Resolution = 64;
+
+// Number of tiles rendered in each direction around the tile the camera is in
+static const int ViewRadius = 1;
+static const int MaximumViewRadius = 16;
 
 // Maximum height of terrain
-static const GLfloat MaxMeshHeight = Resolution / 2;
+static const float MaxMeshHeight = Resolution / 2;
+
+// Distance in vertices between noise samples of coarse preview tiles shown
+// while options change. Must be a factor of TileWidth
+static const unsigned int PreviewStep = 8;
+
+// TILE CACHE
+
+// Memory for generated tiles. A tile of TileWidth 64 takes about 60 KB,
+// 17 KB heights and 43 KB bounds of its 5461 quadtree nodes
+static const size_t TileCacheBytes = 128 * 1024 * 1024;
+
+// Memory for octave layers of tiles, so changing persistence or decreasing
+// octave count only re-weights layers
+static const size_t LayerCacheBytes = 64 * 1024 * 1024;
+
+// TILE STORE
+
+// Directory of tile files, relative to working directory
+static const char TileStoreDirectory[] = "tilecache";
+
+// Size limit of all tile files, least recently used tiles are removed beyond
+static const size_t TileStoreBytes = 256 * 1024 * 1024;
 
 // CAMERA
 
 // Distance to near/far plane of view frustum
-static const GLfloat NearPlane = 0.1f;
-static const GLfloat FarPlane = 1000.0f;
+static const float NearPlane = 0.1f;
+static const float FarPlane = 1000.0f;
 
 // Default camera values
-static const GLfloat Zoom = 45.0f;
-static const GLfloat Yaw = -90.0f;
-static const GLfloat Pitch = -89.0f;
-static const GLfloat Speed = 60.0f;
-static const GLfloat Sensitivity = 0.5f;
+static const float Zoom = 45.0f;
+static const float Yaw = -90.0f;
+static const float Pitch = -89.0f;
+static const float Speed = 60.0f;
+static const float Sensitivity = 0.5f;
 static const glm::vec3 CameraPosition =
     glm::vec3(3 * Defaults::TileWidth / 2, 0.0f, 3 * Defaults::TileWidth / 2);
 
@@ -49,4 +87,20 @@ static const glm::vec3 CameraPosition =
 
 static const int MaximumLod = log2(Defaults::TileWidth);
 
+// Lowest level of detail used for distant tiles
+static const int MinimumLod = 2;
+
+// Tiles closer than this are rendered with MaximumLod. Level of detail
+// decreases by one every time the distance doubles
+static const float LodDistance = 2 * Defaults::TileWidth;
+
+// Depth of skirts below tile border
+static const float SkirtDepth = MaxMeshHeight / 4;
+
+// CULLING
+
+// Deepest quadtree level tested against view frustum. Tiles are culled in
+// 4^CullingLevel patches
+static const int CullingLevel = 3;
+
 } // namespace Constants
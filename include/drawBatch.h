@@ -0,0 +1,22 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+// Collects indexed draws of the currently bound vertex array and submits them
+// with a single glMultiDrawElementsBaseVertex call
+class DrawBatch {
+ public:
+  void clear();
+  // draw count indices starting at firstIndex. baseVertex is added to each
+  // index. Draws continuing the previous one are merged with it
+  void add(const GLsizei &count, const GLuint &firstIndex,
+           const GLint &baseVertex);
+  void draw();
+  size_t size();
+
+ private:
+  std::vector<GLsizei> counts_;
+  std::vector<const GLvoid *> offsets_;
+  std::vector<GLint> baseVertices_;
+};
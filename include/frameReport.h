@@ -0,0 +1,43 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "profiler.h"
+
+// Timings of every frame of a replay, so runs of different builds can be
+// compared. Written as CSV with one row per frame: time on camera path, wall
+// time of frame, tile jobs requested and applied, and milliseconds of each
+// profiled stage. Settings of the run, e.g. whether the tile store was used,
+// precede the rows as comment lines "# <name>: <value>".
+class FrameReport {
+ public:
+  // setting which changes the workload, written to file and summary
+  void addSetting(const std::string &name, const std::string &value);
+  // frameTime in milliseconds. requestedTiles and appliedTiles count during
+  // frame. Stage times are taken from the last ended frame of profiler
+  void addFrame(const double &time, const float &frameTime,
+                const size_t &requestedTiles, const size_t &appliedTiles,
+                const std::vector<Profiler::Stage> &stages);
+  size_t getFrameCount();
+
+  // write CSV file. Returns false if it can't be written
+  bool write(const std::string &path);
+  // settings, number of frames and mean, percentiles and maximum of frame
+  // times
+  void writeSummary(std::ostream &out);
+
+ private:
+  struct Frame {
+    double time;
+    float frameTime;
+    size_t requestedTiles;
+    size_t appliedTiles;
+    std::vector<float> stageTimes; // in order of stageNames_
+  };
+
+  std::vector<std::string> settings_; // "<name>: <value>"
+  std::vector<std::string> stageNames_;
+  std::vector<Frame> frames_;
+};
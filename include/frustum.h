@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "boundingbox.h"
+
+// View frustum given by six planes, extracted from a view projection matrix.
+// Plane normals point into the frustum
+class Frustum {
+ public:
+  enum Result { Outside, Intersects, Inside };
+
+  // frustum containing everything
+  Frustum();
+  explicit Frustum(const glm::mat4 &viewProjection);
+
+  // where box is relative to frustum. Boxes close to a corner of the frustum
+  // may be reported as intersecting although they are outside
+  Result classify(const BoundingBox &box) const;
+
+ private:
+  // a, b, c, d of plane equation ax + by + cz + d = 0
+  glm::vec4 planes_[6];
+};
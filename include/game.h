@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstdio>
 #include <vector>
 #include <ctime>
 
@@ -15,6 +17,10 @@
 #include "tileManager.h"
 #include "defaults.h"
 #include "camera.h"
+#include "cameraPath.h"
+#include "frameReport.h"
+#include "gpuTimer.h"
+#include "profiler.h"
 
 /**
  * @brief Initialize program and run main loop
@@ -22,6 +28,15 @@
 class Game {
  public:
   Game();
+  // fly along path at a fixed timestep instead of keyboard and mouse
+  // control, quit at its end and write timings of all frames to reportPath.
+  // Tiles are always generated without tile store, unless it is set with
+  // setTileStore() afterwards
+  void setReplay(const std::shared_ptr<const CameraPath> &path,
+                 const std::string &reportPath,
+                 const float &timestep = Defaults::ReplayTimestep);
+  // keep generated tiles in directory, no store if it is empty
+  void setTileStore(const std::string &directory);
   int run();
 
  private:
@@ -30,6 +45,7 @@ class Game {
   bool guiClosed_;
   bool leftMouseBtnPressed_;
   std::unique_ptr<TileManager> tileManager_;
+  std::string storeDirectory_;
   glm::vec3 currentPos_;
 
   Camera camera_;
@@ -37,6 +53,15 @@ class Game {
   int frameCount_;
   GLfloat lastFrame_;
   GLfloat lastTime_;
+  std::vector<float> frameTimes_; // ring buffer of recent frame times in ms
+  size_t frameTimesOffset_;
+  GpuTimer terrainGpuTimer_;
+  GpuTimer guiGpuTimer_;
+  std::shared_ptr<const CameraPath> replayPath_;
+  std::string reportPath_;
+  float replayTimestep_;
+  double replayTime_; // on replayPath_
+  FrameReport report_;
   NoiseOptions options_;
   GLFWwindow *window_;
 
@@ -47,6 +72,13 @@ class Game {
 
   void do_movement(const GLfloat &deltaTime);
   void getCurrentPosition();
+  // move camera to pose of current replay time and apply changes of
+  // algorithm and options
+  void replayPath();
+  void recordFrameTime(const GLfloat &deltaTime);
+  void showFrameTimes();
+  // rolling graphs and percentiles of profiled stages, trace recording
+  void showProfiler();
   void setLeftMouseBtnPressed(bool isPressed);
   void showGui();
   void toggleGui();
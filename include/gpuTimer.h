@@ -0,0 +1,40 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include "profiler.h"
+
+// Measures GPU time of a stage with GL_TIME_ELAPSED queries and records it
+// with the profiler on track Profiler::GpuThread. Results are collected a few
+// frames later, so the CPU never waits for the GPU. Queries of
+// GL_TIME_ELAPSED can't be nested, so stages of different timers must not
+// overlap.
+class GpuTimer {
+ public:
+  explicit GpuTimer(const char *name,
+                    Profiler &profiler = Profiler::getShared());
+
+  // create queries. there must be an opengl context!
+  void setup();
+  void cleanup();
+
+  // measure commands between begin() and end(). Frames are skipped while all
+  // queries are still waiting for their results
+  void begin();
+  void end();
+  // record results which became available
+  void collect();
+
+ private:
+  // frames the GPU may lag behind
+  static const int QueryCount = 4;
+
+  const char *name_;
+  Profiler &profiler_;
+  GLuint queries_[QueryCount];
+  double starts_[QueryCount]; // CPU time of begin()
+  bool pending_[QueryCount];
+  int next_;
+  bool active_;
+  bool setUp_;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+// Texture array of single channel float heightmaps, one layer per tile. Like
+// BufferPool, tiles acquire a layer once and update it in place.
+class HeightmapPool {
+ public:
+  HeightmapPool();
+
+  // allocate layerCount layers of width * width heights. there must be an
+  // opengl context!
+  void create(const size_t &layerCount, const GLuint &width);
+  void cleanup();
+
+  // reserve free layer. Returns -1 if all layers are in use
+  int acquire();
+  void release(const int &layer);
+
+  // copy width * width heights into layer
+  void update(const int &layer, const GLfloat *heights);
+
+  GLuint getTexture();
+  size_t getLayerCount();
+  size_t getFreeCount();
+
+ private:
+  GLuint texture_;
+  GLuint width_;
+  size_t layerCount_;
+  std::vector<int> freeLayers_;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+#include "defaults.h"
+#include "quadtree.h"
+
+// Element indices of all levels of detail, shared by all tiles. Indices only
+// depend on Defaults::TileWidth, never on the position of a tile, so they are
+// created once per process and uploaded into a single element buffer. Each
+// level of detail occupies its own range in this buffer: the grid triangles
+// followed by the skirt triangles.
+class IndexBuffer {
+ public:
+  // indices of all levels of detail
+  static const std::vector<GLuint> &getIndices();
+  // quadtree the grid indices are taken from
+  static const Quadtree &getQuadtree();
+
+  // position of first index of level lod
+  static GLuint getOffset(const int &lod);
+  // number of grid indices of level lod, without skirts
+  static GLuint getGridCount(const int &lod);
+  // number of grid and skirt indices of level lod
+  static GLuint getCount(const int &lod);
+  // position of first index of area of quadtree node in level lod. Number of
+  // indices is given by Quadtree::getNodeIndices()
+  static GLuint getNodeOffset(const size_t &node, const int &lod);
+
+  // element buffer holding getIndices(). Created on first call, there must be
+  // an opengl context!
+  static GLuint getBuffer();
+  static void cleanup();
+
+  // indices of skirt triangles of level lod. Skirt vertices are stored after
+  // the grid vertices, one below each border vertex in order north (z = 0),
+  // south (z = tileWidth), west (x = 0), east (x = tileWidth)
+  static std::vector<GLuint> createSkirtIndices(const int &lod,
+                                                const GLuint &tileWidth);
+
+ private:
+  struct Layout {
+    std::vector<GLuint> indices;
+    std::vector<GLuint> offsets;
+    std::vector<GLuint> gridCounts;
+    std::vector<GLuint> counts;
+  };
+
+  static GLuint buffer_;
+
+  static const Layout &getLayout();
+  static Layout createLayout();
+};
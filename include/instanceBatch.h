@@ -0,0 +1,40 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+#include "defaults.h"
+#include "indexBuffer.h"
+
+// Per instance data of a heightmap tile: world space offset and texture layer
+struct TileInstance {
+  GLfloat x;
+  GLfloat z;
+  GLfloat layer;
+};
+
+// Collects tiles rendered from heightmaps, grouped by level of detail. Every
+// group is drawn with one instanced draw call of the shared index buffer.
+class InstanceBatch {
+ public:
+  InstanceBatch();
+
+  void clear();
+  void add(const int &lod, const GLint &x, const GLint &z, const GLint &layer);
+  // copy instances into instance buffer. there must be an opengl context!
+  void upload();
+  // draw all groups with bound vertex array. Sea needs no skirts, so gridOnly
+  // leaves them out
+  void draw(bool gridOnly);
+  void cleanup();
+
+  // number of draw calls of draw()
+  size_t getGroupCount();
+
+  // attribute location of instance data
+  static const GLuint Attribute = 3;
+
+ private:
+  std::vector<std::vector<TileInstance>> groups_;
+  GLuint buffer_;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "defaults.h"
+#include "noise.h"
+#include "tileStore.h"
+
+// Octave layers of recently generated tiles for noise with layers (see
+// NoiseInterface::hasLayers()). Layers don't depend on persistence, so tiles
+// of other persistence or fewer octaves are a cheap weighted sum of cached
+// layers. More octaves only need the added ones. Least recently used tiles
+// are dropped beyond the size limit, a limit of 0 disables the cache.
+// Thread-safe, used by generation jobs.
+class LayerCache {
+ public:
+  explicit LayerCache(const size_t &maximumBytes = Defaults::LayerCacheBytes);
+
+  // fill width x width heights of tile x, z like noise.fillHeights() from
+  // layers. Missing layers are generated and kept. Returns false if noise
+  // has no layers or cache is disabled
+  bool fillHeights(const NoiseInterface &noise, const int &x, const int &z,
+                   const int &width, float *out);
+  void clear();
+
+  void setMaximumBytes(const size_t &maximumBytes);
+  size_t getMaximumBytes();
+  size_t getBytes();
+  // tiles weighted from cached layers only
+  size_t getHits();
+  size_t getMisses();
+
+ private:
+  struct Layers {
+    int octaveCount;
+    int width;
+    std::vector<double> values;
+  };
+  struct Entry {
+    TileKey key;
+    std::shared_ptr<const Layers> layers;
+    std::list<uint64_t>::iterator position; // in usage_
+  };
+
+  size_t maximumBytes_;
+  size_t bytes_;
+  // most recently used tile first
+  std::list<uint64_t> usage_;
+  std::map<uint64_t, Entry> entries_;
+  size_t hits_;
+  size_t misses_;
+  std::mutex mutex_;
+
+  // key of layers of tile x, z, without persistence and octave count
+  static TileKey layerKey(const NoiseInterface &noise, const int &x,
+                          const int &z);
+  void insert(const TileKey &key, const std::shared_ptr<const Layers> &layers);
+  // drop least recently used tiles until size limit is met
+  void evict();
+};
@@ -1,13 +1,15 @@
 #pragma once
 
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
 #include <noise/noise.h>
 #include <memory>
 #include <iostream>
 #include <limits>
+#include <string>
+#include <vector>
 
 #include "defaults.h"
+#include "noiseGraph.h"
+#include "noiseKernel.h"
 
 struct NoiseOptions {
   float frequency;
@@ -17,57 +19,152 @@ struct NoiseOptions {
   int seed;
 };
 
+// Noise generators are immutable once constructed. Changing options creates
+// a new generator with withOptions(), while jobs still running keep using the
+// old one. So a generator may be shared by any number of threads.
 class NoiseInterface {
  public:
-  virtual float getValue(const float &x, const float &y, const float &z) = 0;
-  virtual void initializeOptions() = 0;
-  virtual void setOptions(const NoiseOptions &options) = 0;
+  virtual ~NoiseInterface() {
+  }
+  virtual float getValue(const float &x, const float &y,
+                         const float &z) const = 0;
+  // fill grid of columns x rows values at world coordinates (xOffset +
+  // column, 0, zOffset + row). Row starts at out[row * stride]. Same values
+  // as getValue(), but without a virtual call per sample
+  virtual void fillHeights(const int &xOffset, const int &zOffset,
+                           const int &columns, const int &rows,
+                           const int &stride, float *out) const;
+  // new generator of the same algorithm with options
+  virtual std::shared_ptr<const NoiseInterface>
+  withOptions(const NoiseOptions &options) const = 0;
+
+  // true if values are a weighted sum of octave layers, which don't depend
+  // on persistence and octave count. See NoiseKernel::perlinLayers()
+  virtual bool hasLayers() const;
+  // fill layers of octaves firstOctave up to octave count of width x width
+  // grid at world coordinates like fillHeights(). Octave o of sample i goes
+  // to layers[o * width * width + i]
+  virtual void fillLayers(const int &xOffset, const int &zOffset,
+                          const int &width, const int &firstOctave,
+                          double *layers) const;
+  // weight layers of count samples, same values as fillHeights()
+  virtual void combineLayers(const double *layers, const int &count,
+                             float *out) const;
+
+  NoiseOptions getOptions() const;
+  // algorithm of generator, see Defaults
+  virtual int getAlgorithm() const = 0;
 
-  NoiseOptions getOptions();
+  // generator of algorithm (see Defaults) with its default options
+  static std::shared_ptr<const NoiseInterface> create(const int &algorithm);
+  // algorithm of lower case name, e.g. "ridgedmulti", or -1 if unknown
+  static int parseAlgorithm(const std::string &name);
+  // set option name of options to value. Names are "frequency", "lacunarity",
+  // "octaves", "persistence" and "seed". Returns false and leaves options
+  // alone if name is unknown or value is out of range, e.g. octaves outside
+  // of 1 to 30, which libnoise throws on
+  static bool setOption(const std::string &name, const double &value,
+                        NoiseOptions &options);
 
  protected:
-  NoiseOptions options_;
-  float applyResolution(const float &input);
+  explicit NoiseInterface(const NoiseOptions &options);
+
+  const NoiseOptions options_;
+  static float applyResolution(const float &input);
+  // coordinates passed to libnoise for count world coordinates from offset
+  static std::vector<double> sampleCoordinates(const int &offset,
+                                               const int &count);
 };
 
 class PerlinNoise : public NoiseInterface {
  public:
-  PerlinNoise();
-  float getValue(const float &x, const float &y, const float &z);
-  void initializeOptions();
-  void setOptions(const NoiseOptions &options);
+  explicit PerlinNoise(const NoiseOptions &options = getDefaultOptions());
+  static NoiseOptions getDefaultOptions();
+  float getValue(const float &x, const float &y, const float &z) const;
+  void fillHeights(const int &xOffset, const int &zOffset, const int &columns,
+                   const int &rows, const int &stride, float *out) const;
+  std::shared_ptr<const NoiseInterface>
+  withOptions(const NoiseOptions &options) const;
+  bool hasLayers() const;
+  void fillLayers(const int &xOffset, const int &zOffset, const int &width,
+                  const int &firstOctave, double *layers) const;
+  void combineLayers(const double *layers, const int &count, float *out) const;
+  int getAlgorithm() const;
 
  private:
-  std::shared_ptr<noise::module::Perlin> noise_;
+  std::shared_ptr<const noise::module::Perlin> noise_;
+  // parameters of noise_ for the 2D kernels
+  NoiseKernel::Octaves octaves_;
 };
 
 class RidgedMultiNoise : public NoiseInterface {
  public:
-  RidgedMultiNoise();
-  float getValue(const float &x, const float &y, const float &z);
-  void initializeOptions();
-  void setOptions(const NoiseOptions &options);
+  explicit RidgedMultiNoise(const NoiseOptions &options = getDefaultOptions());
+  static NoiseOptions getDefaultOptions();
+  float getValue(const float &x, const float &y, const float &z) const;
+  void fillHeights(const int &xOffset, const int &zOffset, const int &columns,
+                   const int &rows, const int &stride, float *out) const;
+  std::shared_ptr<const NoiseInterface>
+  withOptions(const NoiseOptions &options) const;
+  int getAlgorithm() const;
 
  private:
-  std::shared_ptr<noise::module::RidgedMulti> noise_;
+  std::shared_ptr<const noise::module::RidgedMulti> noise_;
+  // parameters of noise_ for the 2D kernels
+  NoiseKernel::Octaves octaves_;
 };
 
 class BillowNoise : public NoiseInterface {
  public:
-  BillowNoise();
-  float getValue(const float &x, const float &y, const float &z);
-  void initializeOptions();
-  void setOptions(const NoiseOptions &options);
+  explicit BillowNoise(const NoiseOptions &options = getDefaultOptions());
+  static NoiseOptions getDefaultOptions();
+  float getValue(const float &x, const float &y, const float &z) const;
+  void fillHeights(const int &xOffset, const int &zOffset, const int &columns,
+                   const int &rows, const int &stride, float *out) const;
+  std::shared_ptr<const NoiseInterface>
+  withOptions(const NoiseOptions &options) const;
+  bool hasLayers() const;
+  void fillLayers(const int &xOffset, const int &zOffset, const int &width,
+                  const int &firstOctave, double *layers) const;
+  void combineLayers(const double *layers, const int &count, float *out) const;
+  int getAlgorithm() const;
 
  private:
-  std::shared_ptr<noise::module::Billow> noise_;
+  std::shared_ptr<const noise::module::Billow> noise_;
+  // parameters of noise_ for the 2D kernels
+  NoiseKernel::Octaves octaves_;
 };
 
+// White noise. Each integer world coordinate gets a value from a hash of the
+// coordinate and the seed, so the same coordinate always gets the same value.
+// All other options are ignored
 class RandomNoise : public NoiseInterface {
  public:
-  float getValue(const float &x, const float &y, const float &z);
-  void initializeOptions() {
-  }
-  void setOptions(const NoiseOptions &options) {
-  }
+  explicit RandomNoise(const NoiseOptions &options = getDefaultOptions());
+  static NoiseOptions getDefaultOptions();
+  float getValue(const float &x, const float &y, const float &z) const;
+  void fillHeights(const int &xOffset, const int &zOffset, const int &columns,
+                   const int &rows, const int &stride, float *out) const;
+  std::shared_ptr<const NoiseInterface>
+  withOptions(const NoiseOptions &options) const;
+  int getAlgorithm() const;
+};
+
+// Ridged mountains and billowy plains, selected by Perlin noise and distorted
+// by turbulence, as in the terrain tutorial of libnoise. Evaluated as compiled
+// NoiseGraph. Options configure the mountains, the other modules are derived
+// from them. Values only depend on x and z
+class MountainNoise : public NoiseInterface {
+ public:
+  explicit MountainNoise(const NoiseOptions &options = getDefaultOptions());
+  static NoiseOptions getDefaultOptions();
+  float getValue(const float &x, const float &y, const float &z) const;
+  void fillHeights(const int &xOffset, const int &zOffset, const int &columns,
+                   const int &rows, const int &stride, float *out) const;
+  std::shared_ptr<const NoiseInterface>
+  withOptions(const NoiseOptions &options) const;
+  int getAlgorithm() const;
+
+ private:
+  std::shared_ptr<const NoiseGraph> graph_;
 };
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <noise/noise.h>
+#include <vector>
+
+#include "noiseKernel.h"
+
+// Terrain generator composed of libnoise modules: noise sources, modifiers
+// and combiners. Nodes are added bottom-up and each returns its handle, so a
+// node only refers to nodes added before it. Modules give the same values as
+// their libnoise counterpart at y = 0, except for turbulence().
+//
+// compile() flattens the graph reachable from the output into a list of
+// instructions. Each instruction evaluates one module for a whole block of
+// samples into its own buffer, instead of one chain of virtual GetValue()
+// calls per sample. Sources use the 2D kernels. Unlike libnoise, both sources
+// of select() are always evaluated, which keeps the loops free of branches.
+//
+// A compiled graph is only read by evaluate(), so it may be shared by any
+// number of threads.
+class NoiseGraph {
+ public:
+  // handle of a node
+  typedef int Node;
+
+  NoiseGraph();
+
+  // sources, parameters are read from the configured module
+  Node perlin(const noise::module::Perlin &module);
+  Node billow(const noise::module::Billow &module);
+  Node ridgedMulti(const noise::module::RidgedMulti &module);
+  Node constant(const double &value);
+
+  // modifiers, see noise::module::ScaleBias, Abs, Clamp, Exponent and Invert
+  Node scaleBias(const Node &source, const double &scale, const double &bias);
+  Node abs(const Node &source);
+  Node clamp(const Node &source, const double &lower, const double &upper);
+  Node exponent(const Node &source, const double &exponent);
+  Node invert(const Node &source);
+
+  // combiners, see noise::module::Add, Multiply, Min, Max, Blend and Select
+  Node add(const Node &source0, const Node &source1);
+  Node multiply(const Node &source0, const Node &source1);
+  Node min(const Node &source0, const Node &source1);
+  Node max(const Node &source0, const Node &source1);
+  Node blend(const Node &source0, const Node &source1, const Node &control);
+  Node select(const Node &source0, const Node &source1, const Node &control,
+              const double &lower, const double &upper,
+              const double &edgeFalloff = 0.0);
+
+  // source at randomly displaced coordinates, like noise::module::Turbulence.
+  // Terrain is 2D, so the distortion noise is sampled in the plane y = 0 and
+  // only x and z are displaced. Values differ from the 3D module therefore
+  Node turbulence(const Node &source, const double &frequency,
+                  const double &power, const int &roughness, const int &seed);
+
+  // flatten graph into instructions computing output. Nodes below a
+  // turbulence node are compiled once more for the displaced coordinates
+  void compile(const Node &output);
+  // evaluate compiled graph at count samples (x[i], 0, z[i])
+  void evaluate(const double *x, const double *z, const int &count,
+                double *out) const;
+  double getValue(const double &x, const double &z) const;
+
+  int getNodeCount() const;
+  int getInstructionCount() const;
+
+ private:
+  enum Operation {
+    Perlin,
+    Billow,
+    RidgedMulti,
+    Constant,
+    ScaleBias,
+    Abs,
+    Clamp,
+    Exponent,
+    Invert,
+    Add,
+    Multiply,
+    Min,
+    Max,
+    Blend,
+    Select,
+    Turbulence
+  };
+
+  struct Module {
+    Operation operation;
+    int inputCount;
+    Node inputs[3];
+    double parameters[3];
+    // noise source, or x and z distortion of turbulence
+    NoiseKernel::Octaves octaves[2];
+  };
+
+  struct Instruction {
+    Operation operation;
+    Node node;
+    // registers of inputs
+    int inputs[3];
+    // coordinates the instruction is evaluated at
+    int space;
+    // register written, or coordinates written by turbulence
+    int target;
+  };
+
+  std::vector<Module> nodes_;
+  std::vector<Instruction> program_;
+  int registerCount_;
+  // coordinates of samples, 0 is the input and turbulence adds more
+  int spaceCount_;
+  int output_;
+
+  // append node with the first inputCount inputs
+  Node addNode(const Operation &operation, const int &inputCount,
+               Node input0 = 0, Node input1 = 0, Node input2 = 0);
+  // emit instructions of node evaluated at space, returns its register.
+  // compiled maps node and space to registers already computed
+  int compileNode(const Node &node, const int &space,
+                  std::vector<std::vector<int>> &compiled);
+  // run instruction for count samples of buffers of blockSize samples
+  void execute(const Instruction &instruction, const int &count,
+               const int &blockSize, double *registers, double *spaces,
+               double *scratch) const;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <noise/noise.h>
+
+// Two-dimensional versions of the libnoise modules used for terrain. Terrain
+// is always sampled in the plane y = 0, where the 3D gradient noise of
+// libnoise only depends on the four lattice corners at y = 0. These kernels
+// evaluate just those four corners instead of all eight and give the same
+// values as GetValue(x, 0, z) of the corresponding module.
+//
+// Rows are evaluated in blocks of Lanes with the loops over lanes kept free
+// of calls and branches, so the compiler can vectorize them (e.g. 4 doubles
+// per AVX2 register, 2 per SSE register). Results agree with the 3D modules
+// within float rounding.
+namespace NoiseKernel {
+
+// number of samples evaluated together
+static const int Lanes = 8;
+
+// parameters of a module, see octavesOf()
+struct Octaves {
+  double frequency;
+  double lacunarity;
+  double persistence; // ignored by ridgedMulti()
+  int octaveCount;
+  int seed;
+  noise::NoiseQuality quality;
+  // weight of each octave, only used by ridgedMulti()
+  double spectralWeights[noise::module::RIDGED_MAX_OCTAVE];
+};
+
+// read parameters of module with its getters
+Octaves octavesOf(const noise::module::Perlin &module);
+Octaves octavesOf(const noise::module::Billow &module);
+Octaves octavesOf(const noise::module::RidgedMulti &module);
+
+// evaluate count samples at (x[i], 0, z) and store them as float in out
+void perlin(const Octaves &octaves, const double *x, const double &z,
+            const int &count, float *out);
+void billow(const Octaves &octaves, const double *x, const double &z,
+            const int &count, float *out);
+void ridgedMulti(const Octaves &octaves, const double *x, const double &z,
+                 const int &count, float *out);
+
+// evaluate count samples at (x[i], 0, z[i]) and store them as double in out.
+// For samples off a regular grid, e.g. displaced by turbulence
+void perlin(const Octaves &octaves, const double *x, const double *z,
+            const int &count, double *out);
+void billow(const Octaves &octaves, const double *x, const double *z,
+            const int &count, double *out);
+void ridgedMulti(const Octaves &octaves, const double *x, const double *z,
+                 const int &count, double *out);
+
+// evaluate a single sample at (x, 0, z)
+float perlin(const Octaves &octaves, const double &x, const double &z);
+float billow(const Octaves &octaves, const double &x, const double &z);
+float ridgedMulti(const Octaves &octaves, const double &x, const double &z);
+
+// octave layers: signal of each octave before it is weighted with
+// persistence. Octaves firstOctave up to octaves.octaveCount of count samples
+// at (x[i], 0, z) are written, octave o of sample i to layers[o * stride + i].
+// Layers don't depend on persistence
+void perlinLayers(const Octaves &octaves, const int &firstOctave,
+                  const double *x, const double &z, const int &count,
+                  const int &stride, double *layers);
+void billowLayers(const Octaves &octaves, const int &firstOctave,
+                  const double *x, const double &z, const int &count,
+                  const int &stride, double *layers);
+// weighted sum of the first octaveCount layers of count samples, octave o of
+// sample i at layers[o * count + i], plus offset. Same values as perlin() for
+// perlinLayers() with offset 0 and as billow() for billowLayers() with
+// offset 0.5
+void combineLayers(const double &persistence, const int &octaveCount,
+                   const double &offset, const double *layers,
+                   const int &count, float *out);
+
+// white noise in [0, 1] at integer coordinates x, z. Counter-based: the value
+// is a hash of seed and coordinates, there is no generator state
+float random(const int &seed, const int &x, const int &z);
+// white noise at count integer coordinates (x + i, z)
+void random(const int &seed, const int &x, const int &z, const int &count,
+            float *out);
+
+} // namespace NoiseKernel
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "defaults.h"
+
+// Durations of named stages, e.g. tile generation or buffer uploads, summed
+// per frame. Keeps a rolling history of the last Defaults::FrameTimeHistory
+// frames per stage and can record all events as Chrome trace (see
+// chrome://tracing). Stages may be recorded on any thread, durations of
+// worker threads count for the frame they finish in. Thread-safe
+class Profiler {
+ public:
+  struct Stage {
+    std::string name;
+    // milliseconds per frame, ring buffer starting at offset
+    std::vector<float> history;
+    size_t offset;
+    // percentiles and maximum of history
+    float median;
+    float p95;
+    float p99;
+    float maximum;
+  };
+
+  Profiler();
+  // profiler used by ScopedTimer, created on first use
+  static Profiler &getShared();
+
+  // nothing is recorded while disabled, the default
+  bool isEnabled();
+  void setEnabled(bool enabled);
+
+  // microseconds since profiler was created
+  double now();
+  // add duration in microseconds of stage starting at start to current
+  // frame. thread is the track in traces, the calling thread by default.
+  // name must outlive profiler, e.g. a string literal
+  void record(const char *name, const double &start, const double &duration,
+              const int &thread = -1);
+  // move totals of current frame into history
+  void endFrame();
+  // stages in order of their first record
+  std::vector<Stage> getStages();
+
+  // record events of next frameCount frames and write them to path as
+  // Chrome trace JSON afterwards
+  void startTrace(const std::string &path,
+                  const int &frameCount = Defaults::TraceFrames);
+  bool isTracing();
+  // path of last written trace, empty before
+  std::string getTracePath();
+  // write events recorded so far to path. Returns false if it can't be
+  // written
+  bool writeTrace(const std::string &path);
+  // name shown for track of calling thread in traces
+  void nameThread(const std::string &name);
+
+  // value below which fraction of sorted values lie. sorted must not be
+  // empty
+  static float percentile(const std::vector<float> &sorted,
+                          const float &fraction);
+
+  // track of GPU durations, see GpuTimer
+  static const int GpuThread = 0;
+
+ private:
+  struct Event {
+    const char *name;
+    int thread;
+    double start;
+    double duration;
+  };
+
+  std::chrono::steady_clock::time_point epoch_;
+  std::atomic<bool> enabled_;
+  std::mutex mutex_;
+  std::vector<const char *> names_;
+  std::vector<double> frameTotals_; // microseconds of current frame
+  std::vector<std::vector<float>> history_;
+  size_t offset_;
+  std::map<std::thread::id, int> threads_;
+  std::map<int, std::string> threadNames_;
+  std::vector<Event> events_;
+  int traceFrames_;
+  std::string tracePath_;
+  std::string writtenPath_;
+
+  // number of calling thread, threads are numbered from 1 in order of their
+  // first record. Needs lock
+  int currentThread();
+  // index of stage name, added if it is new. Needs lock
+  size_t stageIndex(const char *name);
+  bool writeEvents(const std::string &path);
+};
+
+// Records time between construction and destruction as stage name, e.g.
+//   ScopedTimer timer("TileManager::update");
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(const char *name,
+                       Profiler &profiler = Profiler::getShared());
+  ~ScopedTimer();
+
+ private:
+  const char *name_;
+  Profiler &profiler_;
+  bool enabled_;
+  double start_;
+};
@@ -1,8 +1,7 @@
 #pragma once
 
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <cmath>
@@ -10,19 +9,70 @@
 
 #include "defaults.h"
 
+// Non-owning view of consecutive indices
+struct IndexSpan {
+  const unsigned int *data;
+  size_t count;
+
+  const unsigned int *begin() const {
+    return data;
+  }
+  const unsigned int *end() const {
+    return data + count;
+  }
+  size_t size() const {
+    return count;
+  }
+  const unsigned int &operator[](const size_t &idx) const {
+    return data[idx];
+  }
+};
+
+// Lowest and highest terrain height inside of a quadtree node
+struct NodeBounds {
+  float minHeight;
+  float maxHeight;
+};
+
 // Data structure for partitioning tile in different levels of detail
 // see https://en.wikipedia.org/wiki/Quadtree
+//
+// The tree is implicit: nodes are stored breadth-first in one array without
+// any pointers. Level l starts at node (4^l - 1) / 3, children of node n are
+// nodes 4n + 1 to 4n + 4. Children are ordered top left, bottom left, bottom
+// right, top right, so the nodes of a level are in the same order as a
+// depth-first traversal would visit them. Indices of a node and all of its
+// descendants on a deeper level are therefore consecutive.
 class Quadtree {
  public:
-  explicit Quadtree(const int &level = 0, const int &startpoint = 0);
-  std::vector<GLuint> getIndicesOfLevel(const int &lod);
+  Quadtree();
+  // quadtree shared by all tiles, created on first use. Thread-safe
+  static const Quadtree &getShared();
 
- private:
-  int level_;
-  int startpoint_;
-  bool isLeaf_;
-  std::vector<GLuint> indices_;
-  std::vector<std::shared_ptr<Quadtree>> children_;
+  // copy of indices of specified level of detail
+  std::vector<unsigned int> getIndicesOfLevel(const int &lod);
+  // indices of specified level of detail without copying
+  IndexSpan getLevel(const int &lod) const;
+  // indices of the area of node on level lod. lod must not be lower than the
+  // level of node
+  IndexSpan getNodeIndices(const size_t &node, const int &lod) const;
+
+  // height bounds of every node, calculated from heights of (TileWidth + 1)^2
+  // vertices. Height of vertex i is at heights[i * stride]
+  std::vector<NodeBounds> calculateBounds(const float *heights,
+                                        const size_t &stride = 1) const;
+
+  // node arithmetic
+  static size_t getNodeCount();
+  static size_t getLevelStart(const int &level);
+  static int getLevelOfNode(const size_t &node);
+  static size_t getChild(const size_t &node, const int &child);
 
-  bool isLeaf();
+  // first vertex and edge length of area covered by node
+  unsigned int getNodeStartpoint(const size_t &node) const;
+  unsigned int getNodeWidth(const size_t &node) const;
+
+ private:
+  // six indices per node, in node order
+  std::vector<unsigned int> indices_;
 };
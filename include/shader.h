@@ -13,13 +13,13 @@ class Shader {
   Shader();
 
   void load(const GLchar *shaderPath, GLenum shaderType);
-  /* const GLchar *vertexSourcePath, const GLchar *fragmentSourcePath); */
+  // link loaded shaders into program
+  void link();
   void use();
+  void cleanup();
   GLuint getProgram();
 
  private:
   GLuint program_;
   std::vector<GLuint> shaderIds_;
-
-  void createProgram();
 };
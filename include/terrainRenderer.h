@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "defaults.h"
+#include "drawBatch.h"
+#include "heightmapPool.h"
+#include "indexBuffer.h"
+#include "instanceBatch.h"
+#include "shader.h"
+#include "tile.h"
+
+// Uniforms shared by all tiles. Layout matches uniform block "Frame" in the
+// shaders (std140: every member is aligned to 16 bytes)
+struct FrameUniforms {
+  glm::mat4 model;
+  glm::mat4 view;
+  glm::mat4 projection;
+  glm::vec4 lightPosition;
+  glm::vec4 lightColor;
+};
+
+// Owns the shader programs used for terrain and sea. Matrices and light are
+// written into a uniform buffer once per frame, tiles don't set any uniforms
+// themselves. Tiles are either drawn from vertex buffers or, in heightmap
+// mode, built by the vertex shader from their heights.
+class TerrainRenderer {
+ public:
+  TerrainRenderer();
+
+  // compile shaders and create uniform buffer. there must be an opengl
+  // context!
+  void setup();
+  void cleanup();
+
+  // update frame uniforms and bind program. Call before rendering tiles
+  void beginFrame(const GLfloat &deltaTime, const glm::mat4 &viewMatrix);
+  // combined model, view and projection matrix of current frame
+  glm::mat4 getViewProjection();
+
+  // point vertex array used for batches at vertex buffer holding the vertices
+  // of all tiles. Call again whenever this buffer is recreated
+  void setVertexBuffer(const GLuint &buffer);
+  // draw terrain and sea of all tiles with one draw call each
+  void renderBatches(DrawBatch &terrain, DrawBatch &sea);
+  // draw tiles from their layer of heightmaps with one instanced draw call per
+  // level of detail each for terrain and sea
+  void renderHeightmaps(InstanceBatch &batch, HeightmapPool &heightmaps,
+                        bool showSea, const float &seaLevel);
+
+ private:
+  std::unique_ptr<Shader> shader_;
+  GLuint batchVAO_; // Vertex Array Object
+  std::unique_ptr<Shader> heightmapShader_;
+  GLuint heightmapVAO_; // Vertex Array Object
+  GLint seaLocation_;
+  GLint seaLevelLocation_;
+  GLuint frameBuffer_; // Uniform Buffer Object
+  FrameUniforms frame_;
+
+  void rotateLight(const GLfloat &deltaTime);
+  void setupHeightmapShader();
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed number of worker threads processing submitted jobs in FIFO order.
+// Used to generate tile data off the render thread.
+class ThreadPool {
+ public:
+  // threadCount of 0 uses all but one hardware thread (at least one)
+  explicit ThreadPool(size_t threadCount = 0);
+  ~ThreadPool();
+
+  // queue job and return future for its result
+  template <typename Function>
+  std::future<typename std::result_of<Function()>::type>
+  submit(Function function);
+
+  size_t getThreadCount();
+  size_t getQueuedCount();
+
+ private:
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> jobs_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stop_;
+
+  void work();
+};
+
+template <typename Function>
+std::future<typename std::result_of<Function()>::type>
+ThreadPool::submit(Function function) {
+  typedef typename std::result_of<Function()>::type Result;
+
+  // std::function needs a copyable target, so wrap packaged_task in shared_ptr
+  auto task = std::make_shared<std::packaged_task<Result()>>(function);
+  std::future<Result> result = task->get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back([task]() { (*task)(); });
+  }
+  condition_.notify_one();
+  return result;
+}
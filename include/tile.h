@@ -1,6 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -13,10 +16,21 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "boundingbox.h"
+#include "bufferPool.h"
 #include "defaults.h"
-#include "quadtree.h"
-#include "shader.h"
+#include "drawBatch.h"
+#include "frustum.h"
+#include "heightmapPool.h"
+#include "indexBuffer.h"
+#include "instanceBatch.h"
 #include "noise.h"
+#include "threadPool.h"
+#include "tileGenerator.h"
+#include "tileStore.h"
+
+class LayerCache;
+class TileCache;
 
 // Vertex defined by position and color
 struct Vertex {
@@ -27,61 +41,139 @@ struct Vertex {
 class Tile {
  public:
   explicit Tile(const int &x, const int &z,
-                const std::shared_ptr<NoiseInterface> &noise =
-                    std::shared_ptr<NoiseInterface>(new PerlinNoise),
+                const std::shared_ptr<const NoiseInterface> &noise =
+                    std::shared_ptr<const NoiseInterface>(new PerlinNoise),
+                const GLuint &tileWidth = Defaults::TileWidth);
+  // create tile from already generated data
+  explicit Tile(TileData &data,
+                const std::shared_ptr<const NoiseInterface> &noise,
                 const GLuint &tileWidth = Defaults::TileWidth);
-  void setup();
-  void update(const GLfloat &deltaTime);
-  void render(const glm::mat4 &viewMatrix);
+  // acquire buffer slots from pool and upload vertices
+  void setup(BufferPool &pool);
+  // acquire texture layer from heightmaps and upload heights only
+  void setup(HeightmapPool &heightmaps);
+  void render();
+  // queue draws of terrain and sea instead of rendering them directly
+  void addToBatch(DrawBatch &terrain, DrawBatch &sea);
+  // queue only quadtree nodes of tile intersecting frustum. Returns number of
+  // visible patches, 0 if whole tile is culled
+  GLuint addToBatch(DrawBatch &terrain, DrawBatch &sea, const Frustum &frustum);
+  // queue tile for instanced rendering from its heightmap
+  void addToBatch(InstanceBatch &batch);
+  // box around terrain, skirts and sea of tile
+  BoundingBox getBoundingBox();
+  bool isVisible(const Frustum &frustum);
+  // number of patches a tile is split in for culling
+  static GLuint getPatchCount();
   void cleanup();
-  void updateCoordinates(const int &x, const int &z);
-  void changeAlgorithm(const std::shared_ptr<NoiseInterface> noise);
+
+  // generate new vertices on pool and keep rendering current ones until
+  // applyFinishedJob() picks up the result
+  void requestCoordinates(const int &x, const int &z, ThreadPool &pool);
+  void requestAlgorithm(const std::shared_ptr<const NoiseInterface> noise,
+                        ThreadPool &pool);
+  // generate coarse preview with noise. Queue it before requestAlgorithm(),
+  // it is shown until the full tile is done
+  void requestPreview(const std::shared_ptr<const NoiseInterface> noise,
+                      ThreadPool &pool);
+  // upload result of finished job. Returns true if a result was applied
+  bool applyFinishedJob();
+  bool hasPendingJob();
+  bool hasPendingPreview();
+  void waitForPendingJob();
+
+  // look up and save heights in store and caches, which have to outlive all
+  // jobs
+  void setStore(TileStore *store);
+  void setCache(TileCache *cache);
+  void setLayerCache(LayerCache *layers);
   void setSeaLevel(const float &seaLevel);
   float getSeaLevel();
   void setShowSea(bool showSea);
 
+  // level of detail used for rendering. Choose from distance with selectLod()
+  void setLod(const int &lod);
+  int getLod();
+  static int selectLod(const float &distance);
+  // distance between position and closest point of tile
+  float distanceTo(const glm::vec3 &position);
+  // number of rendered terrain triangles at current lod, including skirts
+  GLuint getTriangleCount();
+
+  // bytes of vertex buffer slot needed by terrain of a tile
+  static size_t getSlotSize(const GLuint &tileWidth);
+  // set attribute pointers of currently bound vertex array for Vertex data
+  // starting offset bytes into the bound vertex buffer
+  static void setupVertexAttributes(const size_t &offset);
+
+  // height bounds of quadtree nodes
+  const std::vector<NodeBounds> &getBounds();
+  const std::vector<GLfloat> &getHeights();
+
   // for testing
   std::vector<GLuint> getIndices();
   std::vector<Vertex> getVertices();
 
  private:
-  std::shared_ptr<NoiseInterface> noise_;
+  std::shared_ptr<const NoiseInterface> noise_;
+  TileStore *store_;
+  TileCache *cache_;
+  LayerCache *layers_;
   GLuint tileWidth_;
+  int x_;
+  int z_;
   int xOffset_;
   int zOffset_;
-  std::unique_ptr<Quadtree> quadtree_;
   GLuint verticesCount_;
-
-  std::unique_ptr<Shader> shader_;
-  std::vector<Vertex> vertices_;
+  std::future<TileData> pendingJob_;
+  std::future<TileData> previewJob_;
+  int pendingX_;
+  int pendingZ_;
+  int previewX_;
+  int previewZ_;
+  // set when a job is superseded, so it is skipped if it hasn't started yet
+  std::shared_ptr<std::atomic<bool>> jobSuperseded_;
+  std::shared_ptr<std::atomic<bool>> previewSuperseded_;
+
+  // vertices are built from heights only when uploading them
+  std::vector<GLfloat> heights_;
+  std::vector<NodeBounds> bounds_;
+
+  int lod_;
+
+  // terrain and sea vertices live in slots of a shared vertex buffer
+  BufferPool *pool_;
+  int terrainSlot_;
+  int seaSlot_;
 
   GLuint terrainVAO_; // Vertex Array Object
-  std::vector<GLuint> terrainIndices_;
-
   GLuint seaVAO_; // Vertex Array Object
-  std::vector<Vertex> seaVertices_;
-  std::vector<GLuint> seaIndices_;
-  float seaLevel_;
-  bool showSea_;
-
-  GLint objectColorLoc_;
-  GLint lightColorLoc_;
-  GLint lightPosLoc_;
-  glm::vec3 lightPos_;
-
-  void createVertices();
-  void createTerrain();
-  void createSea();
 
-  void setupShader();
+  // alternatively, heights live in a layer of a texture array
+  HeightmapPool *heightmaps_;
+  int layer_;
 
-  void setupBuffers();
-  void setupTerrainBuffers();
-  void setupSeaBuffers();
-
-  void rotateLight();
+  float seaLevel_;
+  bool showSea_;
 
-  glm::vec3 colorFromHeight(const GLfloat &height);
-  float getHeightAtNeighborIndex(const int &curIdx, const int &neighborIdx);
-  glm::vec3 calculateCoordinates(const int &curIdx, const int &neighborIdx);
+  void createHeights();
+  void applyData(TileData &data);
+  std::vector<Vertex> createVertices();
+  // skirts hang down from the tile border and hide cracks between neighbouring
+  // tiles of different level of detail
+  std::vector<Vertex> createSkirts(const std::vector<Vertex> &vertices);
+  std::vector<Vertex> createSea();
+
+  // box around terrain and sea of area of node, without skirts
+  BoundingBox getNodeBox(const size_t &node);
+  GLuint addVisibleNodes(const size_t &node, const int &level,
+                         const Frustum &frustum, DrawBatch &terrain,
+                         DrawBatch &sea);
+
+  void setupVertexArray(GLuint &vao, const int &slot);
+  void uploadBuffers();
+  void uploadTerrain();
+  void uploadSea();
+
+  static glm::vec3 colorFromHeight(const GLfloat &height);
 };
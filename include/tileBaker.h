@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "defaults.h"
+#include "noise.h"
+
+// Rectangle of columns x rows tiles, starting at tile coordinates x, z
+struct TileRegion {
+  int x;
+  int z;
+  int columns;
+  int rows;
+};
+
+// Generates large regions of tiles offline on all cores and streams them to
+// disk, so only a few tiles per thread are held in memory. Heights are
+// written as 16 bit values, 0 at height 0 up to 65535 at
+// Defaults::MaxMeshHeight, clamped beyond.
+class TileBaker {
+ public:
+  enum Format {
+    // directory with one file tile_<x>_<z>.r16 of 16 bit heights per tile and
+    // a text file region describing them
+    Raw,
+    // single file of a header and the tiles of all rows, west to east
+    Container
+  };
+
+  // called after each written tile with number of written and all tiles
+  typedef std::function<void(const size_t &done, const size_t &total)>
+      Progress;
+
+  explicit TileBaker(const std::shared_ptr<const NoiseInterface> &noise,
+                     const unsigned int &tileWidth = Defaults::TileWidth);
+
+  // generate tiles of region on threadCount threads, 0 uses all hardware
+  // threads, and write them to path in format. Returns false if region is
+  // empty or path can't be written
+  bool bake(const TileRegion &region, const std::string &path,
+            const Format &format, const size_t &threadCount = 0);
+  void setProgress(const Progress &progress);
+
+  // statistics of last bake()
+  size_t getTileCount();
+  double getSeconds();
+  double getTilesPerSecond();
+
+  static uint16_t quantize(const float &height);
+  static float dequantize(const uint16_t &value);
+  // read heights of tile at tile coordinates x, z from container file.
+  // Returns false if file is no container or tile is outside its region
+  static bool readTile(const std::string &path, const int &x, const int &z,
+                       std::vector<float> &heights);
+
+ private:
+  std::shared_ptr<const NoiseInterface> noise_;
+  unsigned int tileWidth_;
+  Progress progress_;
+  size_t tileCount_;
+  double seconds_;
+};
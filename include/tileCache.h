@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "defaults.h"
+#include "tileGenerator.h"
+#include "tileStore.h"
+
+// Recently generated tiles in memory, so tiles scrolling back into view or
+// switching back to a previous algorithm or options need no generation.
+// Least recently used tiles are dropped beyond the size limit, heights and
+// node bounds are counted. Thread-safe, tiles are looked up and inserted by
+// generation jobs.
+class TileCache {
+ public:
+  explicit TileCache(const size_t &maximumBytes = Defaults::TileCacheBytes);
+
+  // copy tile of key with count heights into data. Returns false and leaves
+  // data alone if tile is not cached, also if it has another number of
+  // heights, e.g. of another tile width
+  bool find(const TileKey &key, const size_t &count, TileData &data);
+  // tile of key or nullptr, without counting it as hit or miss or changing
+  // usage order. Used to read borders of neighbours
+  std::shared_ptr<const TileData> peek(const TileKey &key);
+  void insert(const TileKey &key, const TileData &data);
+  void clear();
+
+  void setMaximumBytes(const size_t &maximumBytes);
+  size_t getMaximumBytes();
+  size_t getBytes();
+  // number of tiles kept
+  size_t getSize();
+  size_t getHits();
+  size_t getMisses();
+
+ private:
+  struct Entry {
+    TileKey key;
+    std::shared_ptr<const TileData> data;
+    std::list<uint64_t>::iterator position; // in usage_
+  };
+
+  size_t maximumBytes_;
+  size_t bytes_;
+  // most recently used tile first
+  std::list<uint64_t> usage_;
+  std::map<uint64_t, Entry> entries_;
+  size_t hits_;
+  size_t misses_;
+  std::mutex mutex_;
+
+  // memory of heights and bounds of tile
+  static size_t getBytes(const TileData &data);
+  // drop least recently used tiles until size limit is met
+  void evict();
+};
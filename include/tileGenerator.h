@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "defaults.h"
+#include "noise.h"
+#include "quadtree.h"
+
+class LayerCache;
+class TileCache;
+class TileStore;
+
+// Result of a tile generation job. Tile coordinates and heights of the
+// (tileWidth + 1)^2 grid vertices row by row, created on a worker thread
+// without any OpenGL calls
+struct TileData {
+  int x;
+  int z;
+  std::vector<float> heights;
+  std::vector<NodeBounds> bounds; // height bounds of each quadtree node
+};
+
+// Heights of terrain tiles, without any rendering. Used by Tile jobs, and
+// without a display by tests, benchmarks and batch tools
+class TileGenerator {
+ public:
+  // create heights of tile at tile coordinates x, z. Thread-safe, noise is
+  // immutable. Tiles are taken from cache in memory or store on disk if
+  // possible, otherwise they are generated, from octave layers if possible,
+  // and added to both. Heights from store are quantized to 16 bit, see
+  // TileStore::load(), so only generation without store is exact
+  static TileData generate(const int &x, const int &z,
+                           const std::shared_ptr<const NoiseInterface> &noise,
+                           const unsigned int &tileWidth,
+                           TileStore *store = nullptr,
+                           TileCache *cache = nullptr,
+                           LayerCache *layers = nullptr);
+  // heights bilinearly interpolated from samples every Defaults::PreviewStep
+  // vertices. Full tile from cache if it has one
+  static TileData generatePreview(
+      const int &x, const int &z,
+      const std::shared_ptr<const NoiseInterface> &noise,
+      const unsigned int &tileWidth, TileCache *cache = nullptr);
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// World tile coordinates, tile x, z covers x * TileWidth to (x + 1) *
+// TileWidth
+struct TileCoordinates {
+  int x;
+  int z;
+};
+
+// Square grid of size * size tiles around a center tile, size = 2 * radius
+// + 1. Grid is toroidal: tile at world tile coordinates x, z lives in slot
+// (x mod size, z mod size). When the center moves, a tile that leaves the
+// grid on one side is reused for the newly exposed tile on the opposite side
+// without moving anything around.
+//
+// e.g. radius 1, center tile 4,1. Number is tile x coordinate:
+// +----- x
+// |3 4 5      slots hold tiles  3 4 5  ->  moving east  6 4 5
+// |3 4 5      x mod 3:          0 1 2      to tile 5,1: 6 4 5
+// |3 4 5                                                6 4 5
+// z
+class TileGrid {
+ public:
+  explicit TileGrid(const int &radius = 0, const int &centerX = 0,
+                    const int &centerZ = 0);
+
+  int getRadius() const;
+  // tiles per side
+  int getSize() const;
+  size_t getSlotCount() const;
+  int getCenterX() const;
+  int getCenterZ() const;
+
+  // slot of tile x, z, also of negative coordinates
+  size_t slot(const int &x, const int &z) const;
+  bool contains(const int &x, const int &z) const;
+  // all tiles of grid row by row
+  std::vector<TileCoordinates> getTiles() const;
+  // move center to tile x, z. Returns tiles inside of new grid but outside of
+  // old grid row by row, each takes the slot of a tile that left the grid.
+  // Tiles in both grids are skipped column by column, so this is linear in
+  // the number of exposed tiles instead of quadratic in size
+  std::vector<TileCoordinates> moveTo(const int &x, const int &z);
+
+ private:
+  int radius_;
+  int size_;
+  int centerX_;
+  int centerZ_;
+};
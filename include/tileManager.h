@@ -1,39 +1,122 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <map>
 #include <glm/glm.hpp>
 #include "tile.h"
 
+#include "bufferPool.h"
+#include "drawBatch.h"
+#include "heightmapPool.h"
+#include "instanceBatch.h"
+#include "layerCache.h"
 #include "noise.h"
+#include "terrainRenderer.h"
+#include "threadPool.h"
+#include "tileCache.h"
+#include "tileGrid.h"
+#include "tileStore.h"
 
 class TileManager {
 
  public:
-  void initialize(glm::vec3 const &currentPos_);
-  void update(glm::vec3 const &currentPos_);
+  // tiles are kept in store at storeDirectory, no store if it is empty
+  void initialize(glm::vec3 const &currentPos,
+                  const std::string &storeDirectory =
+                      Defaults::TileStoreDirectory);
+  void update(glm::vec3 const &currentPos);
   void renderAll(const GLfloat &deltaTime, const glm::mat4 &viewMatrix);
   void cleanUp();
   void setTileAlgorithm(const int &algorithm);
   NoiseOptions getOptions();
+  // tiles are regenerated in update(), see requestOptions()
   void setTileAlgorithmOptions(const NoiseOptions &options);
   float getSeaLevel();
   void setSeaLevel(const float &seaLevel);
   bool getShowSea();
   void setShowSea(bool showSea);
+  bool getLodEnabled();
+  void setLodEnabled(bool lodEnabled);
+  size_t getTriangleCount();
+  // draw all tiles with a constant number of draw calls
+  bool getBatched();
+  void setBatched(bool batched);
+  size_t getDrawCalls();
+  // skip tiles and quadtree nodes outside of view frustum
+  bool getCullingEnabled();
+  void setCullingEnabled(bool cullingEnabled);
+  size_t getVisibleTiles();
+  size_t getCulledTiles();
+  size_t getVisiblePatches();
+  size_t getCulledPatches();
+  // upload only heights and build vertices in vertex shader
+  bool getHeightmapMode();
+  void setHeightmapMode(bool heightmapMode);
+  // hits and misses of tile lookups in store on disk
+  bool getStoreEnabled();
+  size_t getStoreHits();
+  size_t getStoreMisses();
+  size_t getStoreBytes();
+  // hits and misses of tile lookups in memory
+  size_t getCacheHits();
+  size_t getCacheMisses();
+  size_t getCacheSize();
+  size_t getCacheBytes();
+  // keep octave layers of tiles, so persistence and octave count changes
+  // only re-weight them
+  bool getLayersEnabled();
+  void setLayersEnabled(bool layersEnabled);
+  size_t getLayerBytes();
+  int getViewRadius();
+  void setViewRadius(const int &viewRadius);
+  // tile generation jobs requested and results applied since initialize(),
+  // including previews
+  size_t getRequestedTiles();
+  size_t getAppliedTiles();
 
  private:
   int currentAlgorithm_;
-  std::map<int, std::shared_ptr<NoiseInterface>> noiseCache_;
-  std::shared_ptr<NoiseInterface> noise_;
+  std::map<int, std::shared_ptr<const NoiseInterface>> noiseCache_;
+  std::shared_ptr<const NoiseInterface> noise_;
+  // options changed since tiles were last requested
+  bool optionsChanged_;
+  // camera position of last update(), new grids are created around it
   glm::vec3 currentPos_;
-  glm::vec3 previousPos_;
   std::vector<std::unique_ptr<Tile>> tiles_;
+  int viewRadius_;
+  TileGrid grid_;
   float seaLevel_;
   bool showSea_;
+  bool lodEnabled_;
+  size_t triangleCount_;
+  // declared before pool_, so they outlive running jobs
+  TileStore store_;
+  TileCache cache_;
+  LayerCache layers_;
+  ThreadPool pool_;
+  BufferPool vertexPool_;
+  TerrainRenderer renderer_;
+  DrawBatch terrainBatch_;
+  DrawBatch seaBatch_;
+  bool batched_;
+  size_t drawCalls_;
+  HeightmapPool heightmapPool_;
+  InstanceBatch instanceBatch_;
+  bool heightmapMode_;
+  bool cullingEnabled_;
+  size_t visibleTiles_;
+  size_t visiblePatches_;
+  size_t requestedTiles_;
+  size_t appliedTiles_;
 
+  void createTiles();
+  void destroyTiles();
+  void updateLod(const glm::vec3 &position);
   void setNoise(const int &algorithm);
   void updatePosition();
   void updateTiles();
+  // request previews and full tiles of noise_ for all tiles
+  void requestOptions();
 };
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "noise.h"
+
+// Identifies the heights of a tile: same algorithm, options and coordinates
+// always give the same heights
+struct TileKey {
+  int algorithm;
+  NoiseOptions options;
+  int x;
+  int z;
+
+  TileKey(const NoiseInterface &noise, const int &x, const int &z);
+  // FNV-1a hash of all fields
+  uint64_t hash() const;
+  bool operator==(const TileKey &other) const;
+};
+
+// Persistent cache of generated tile heights on disk. Every tile is a file
+// named after the hash of its key, holding the key and its heights quantized
+// to 16 bit. Least recently used tiles are removed when the files exceed the
+// size limit. Thread-safe, tiles are loaded and saved by generation jobs.
+class TileStore {
+ public:
+  TileStore();
+  ~TileStore();
+
+  // use directory for tile files, create it if needed. Returns false if it
+  // can't be created, the store stays closed then
+  bool open(const std::string &directory, const size_t &maximumBytes);
+  // write usage order to index file of directory
+  void close();
+  bool isOpen();
+
+  // read count heights of key into heights. Returns false if tile is not in
+  // store. Loaded heights are quantized: they differ from generated ones by
+  // up to half a step of (maximum - minimum) / 65535 of the tile, so the same
+  // tile may differ slightly depending on whether it was stored before.
+  // Cached neighbours pass this on to borders copied from them
+  bool load(const TileKey &key, const size_t &count,
+            std::vector<float> &heights);
+  void save(const TileKey &key, const std::vector<float> &heights);
+  // remove all tile files
+  void clear();
+
+  size_t getBytes();
+  size_t getTileCount();
+  size_t getHits();
+  size_t getMisses();
+
+  // heights are stored as minimum + value * scale with 16 bit values
+  static void quantize(const std::vector<float> &heights, float &minimum,
+                       float &scale, std::vector<uint16_t> &values);
+  static void dequantize(const uint16_t *values, const size_t &count,
+                         const float &minimum, const float &scale,
+                         std::vector<float> &heights);
+
+ private:
+  struct Entry {
+    size_t bytes;
+    std::list<uint64_t>::iterator position; // in usage_
+  };
+
+  std::string directory_;
+  size_t maximumBytes_;
+  bool open_;
+  // most recently used tile first
+  std::list<uint64_t> usage_;
+  std::map<uint64_t, Entry> entries_;
+  size_t bytes_;
+  size_t hits_;
+  size_t misses_;
+  // number of next temporary file, so concurrent saves never share one
+  size_t temporaryCount_;
+  std::mutex mutex_;
+
+  std::string getPath(const uint64_t &hash);
+  std::string getIndexPath();
+  void readIndex();
+  // add tile files missing from index, drop entries without file and remove
+  // temporary files of interrupted saves
+  void scanDirectory();
+  void writeIndex();
+  // move tile to front of usage order, add it if it is unknown
+  void touch(const uint64_t &hash, const size_t &bytes);
+  void remove(const uint64_t &hash);
+  // remove least recently used tiles until size limit is met
+  void evict();
+};
@@ -5,8 +5,14 @@ out vec4 color;
 in vec3 fragmentColor;
 in vec3 fragmentPosition;
 
-uniform vec3 lightColor;
-uniform vec3 lightPosition;
+// shared by all tiles, updated once per frame
+layout (std140) uniform Frame {
+  mat4 model;
+  mat4 view;
+  mat4 projection;
+  vec4 lightPosition;
+  vec4 lightColor;
+};
 	
 void main() {
 
@@ -15,11 +21,11 @@ void main() {
         dFdy(fragmentPosition)));
 
   // ambient lighting
-  vec3 ambient = 0.3f * lightColor;
+  vec3 ambient = 0.3f * lightColor.rgb;
 
   // diffuse lighting
-  vec3 lightDirection = normalize(lightPosition - fragmentPosition);
-  vec3 diffuse = max(dot(normal, lightDirection), 0.0f) * lightColor;
+  vec3 lightDirection = normalize(lightPosition.xyz - fragmentPosition);
+  vec3 diffuse = max(dot(normal, lightDirection), 0.0f) * lightColor.rgb;
 
   // result
   vec3 result = (ambient + diffuse) * fragmentColor;
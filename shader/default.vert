@@ -8,9 +8,14 @@ out vec3 fragmentPosition;
 out vec3 normal;
 out vec3 fragmentColor;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// shared by all tiles, updated once per frame
+layout (std140) uniform Frame {
+  mat4 model;
+  mat4 view;
+  mat4 projection;
+  vec4 lightPosition;
+  vec4 lightColor;
+};
 
 void main() {
 	gl_Position = projection * view * model * vec4(position, 1.0f);
@@ -18,4 +23,3 @@ void main() {
   fragmentColor = colorIn;
   normal = normalIn;
 }
-
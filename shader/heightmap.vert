@@ -0,0 +1,76 @@
+#version 330 core
+
+// world space offset of tile in x and z, layer of its heightmap
+layout (location = 3) in vec3 tileIn;
+
+out vec3 fragmentPosition;
+out vec3 fragmentColor;
+
+// shared by all tiles, updated once per frame
+layout (std140) uniform Frame {
+  mat4 model;
+  mat4 view;
+  mat4 projection;
+  vec4 lightPosition;
+  vec4 lightColor;
+};
+
+uniform sampler2DArray heightmaps;
+uniform int tileWidth;
+uniform float maxHeight;
+uniform float skirtDepth;
+
+// draw flat sea at seaLevel instead of terrain
+uniform bool sea;
+uniform float seaLevel;
+
+// same height zones as Tile::colorFromHeight
+vec3 colorFromHeight(float height) {
+  if (height > 0.9f * maxHeight) {
+    return vec3(0.8f, 0.8f, 0.8f);
+  }
+  if (height > 0.6f * maxHeight) {
+    return vec3(0.5f, 0.5f, 0.5f);
+  }
+  if (height > 0.15f * maxHeight) {
+    return vec3(0.2f, 0.4f, 0.25f);
+  }
+  return vec3(0.2f, 0.6f, 0.25f);
+}
+
+void main() {
+  // index is a grid vertex or one of the skirt vertices following them. Skirt
+  // vertices are ordered by edge: north, south, west, east
+  int width = tileWidth + 1;
+  int index = gl_VertexID;
+  ivec2 grid = ivec2(index % width, index / width);
+  bool skirt = index >= width * width;
+  if (skirt) {
+    int edge = (index - width * width) / width;
+    int i = (index - width * width) % width;
+    if (edge == 0) {
+      grid = ivec2(i, 0);
+    } else if (edge == 1) {
+      grid = ivec2(i, tileWidth);
+    } else if (edge == 2) {
+      grid = ivec2(0, i);
+    } else {
+      grid = ivec2(tileWidth, i);
+    }
+  }
+
+  vec3 position = vec3(tileIn.x + grid.x, 0.0f, tileIn.y + grid.y);
+  if (sea) {
+    // same waves as Tile::createSea
+    position.y = seaLevel + 0.3f * sin(1.2f * position.x) *
+        sin(1.3f * position.z);
+    fragmentColor = vec3(0.0f, 0.5f, 1.0f);
+  } else {
+    float height = texelFetch(heightmaps, ivec3(grid, int(tileIn.z)), 0).r;
+    position.y = skirt ? height - skirtDepth : height;
+    fragmentColor = colorFromHeight(height);
+  }
+
+  gl_Position = projection * view * model * vec4(position, 1.0f);
+  fragmentPosition = vec3(model * vec4(position, 1.0f));
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arguments.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace Arguments {
+
+const char *getValue(const char *argument, const char *name) {
+  size_t length = std::strlen(name);
+  if (std::strncmp(argument, name, length) != 0 || argument[length] != '=') {
+    return nullptr;
+  }
+  return argument + length + 1;
+}
+
+bool parseInteger(const char *text, long &value) {
+  char *end = nullptr;
+  errno = 0;
+  value = std::strtol(text, &end, 10);
+  return end != text && *end == '\0' && errno == 0;
+}
+
+bool parseNumber(const char *text, double &value) {
+  char *end = nullptr;
+  errno = 0;
+  value = std::strtod(text, &end);
+  return end != text && *end == '\0' && errno == 0;
+}
+
+} // namespace Arguments
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Offline baking of tile regions without a display, e.g.
+//   litlanesBake --algorithm=ridgedmulti --octaves=8 --region=0,0,256,256
+//                --format=container --output=region.lltc
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "arguments.h"
+#include "defaults.h"
+#include "noise.h"
+#include "tileBaker.h"
+
+static const char Usage[] =
+    "Usage: litlanesBake [options]\n"
+    "  --algorithm=perlin|ridgedmulti|billow|random|mountains\n"
+    "  --frequency=<f> --lacunarity=<f> --octaves=<1-30> --persistence=<f>\n"
+    "  --seed=<n>           noise options, defaults of algorithm otherwise\n"
+    "  --region=x,z,columns,rows\n"
+    "                       tiles to bake, default 0,0,16,16\n"
+    "  --format=raw|container\n"
+    "                       .r16 file per tile in output directory, or one\n"
+    "                       container file. Default raw\n"
+    "  --output=<path>      default baked\n"
+    "  --threads=<n>        default all hardware threads\n";
+
+int main(int argc, char **argv) {
+  int algorithm = Defaults::Perlin;
+  // options are applied once algorithm is known. Names without leading "--"
+  // are those of NoiseInterface::setOption()
+  const char *optionNames[] = {"--frequency", "--lacunarity", "--octaves",
+                               "--persistence", "--seed"};
+  double options[5];
+  bool optionSet[5] = {false, false, false, false, false};
+  TileRegion region = {0, 0, 16, 16};
+  TileBaker::Format format = TileBaker::Raw;
+  std::string output = "baked";
+  size_t threadCount = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--help") == 0) {
+      std::cout << Usage;
+      return 0;
+    }
+    const char *value = nullptr;
+    int option = 0;
+    while (option < 5 &&
+           !(value = Arguments::getValue(argv[i], optionNames[option]))) {
+      option++;
+    }
+
+    bool valid = false;
+    if (option < 5) {
+      // octaves and seed are integers. Range is the same for all
+      // algorithms, so it is checked right away
+      long integer = 0;
+      if (option == 2 || option == 4) {
+        valid = Arguments::parseInteger(value, integer);
+        options[option] = integer;
+      } else {
+        valid = Arguments::parseNumber(value, options[option]);
+      }
+      NoiseOptions checked = PerlinNoise::getDefaultOptions();
+      valid = valid && NoiseInterface::setOption(optionNames[option] + 2,
+                                                 options[option], checked);
+      optionSet[option] = true;
+    } else if ((value = Arguments::getValue(argv[i], "--algorithm"))) {
+      algorithm = NoiseInterface::parseAlgorithm(value);
+      valid = algorithm >= 0;
+    } else if ((value = Arguments::getValue(argv[i], "--region"))) {
+      int length = 0;
+      valid = std::sscanf(value, "%d,%d,%d,%d%n", &region.x, &region.z,
+                          &region.columns, &region.rows, &length) == 4 &&
+              value[length] == '\0';
+    } else if ((value = Arguments::getValue(argv[i], "--format"))) {
+      valid = std::strcmp(value, "raw") == 0 ||
+              std::strcmp(value, "container") == 0;
+      format = std::strcmp(value, "raw") == 0 ? TileBaker::Raw
+                                              : TileBaker::Container;
+    } else if ((value = Arguments::getValue(argv[i], "--output"))) {
+      output = value;
+      valid = !output.empty();
+    } else if ((value = Arguments::getValue(argv[i], "--threads"))) {
+      long count = 0;
+      valid = Arguments::parseInteger(value, count) && count >= 0;
+      threadCount = count;
+    }
+    if (!valid) {
+      std::cerr << "Error: invalid argument " << argv[i] << "\n" << Usage;
+      return 1;
+    }
+  }
+
+  std::shared_ptr<const NoiseInterface> noise =
+      NoiseInterface::create(algorithm);
+  NoiseOptions noiseOptions = noise->getOptions();
+  for (int option = 0; option < 5; option++) {
+    if (optionSet[option]) {
+      NoiseInterface::setOption(optionNames[option] + 2, options[option],
+                                noiseOptions);
+    }
+  }
+  noise = noise->withOptions(noiseOptions);
+
+  // progress once per row of tiles
+  TileBaker baker(noise);
+  baker.setProgress([&region](const size_t &done, const size_t &total) {
+    if (done % region.columns == 0 || done == total) {
+      std::cout << "\rBaked " << done << " / " << total << " tiles"
+                << std::flush;
+    }
+  });
+  if (!baker.bake(region, output, format, threadCount)) {
+    std::cout << std::endl;
+    return 1;
+  }
+
+  std::printf("\n%zu tiles in %.2f s, %.1f tiles/s\n", baker.getTileCount(),
+              baker.getSeconds(), baker.getTilesPerSecond());
+  return 0;
+}
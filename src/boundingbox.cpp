@@ -20,7 +20,11 @@
 #include "boundingbox.h"
 
 BoundingBox::BoundingBox(glm::vec3 center, float extents)
-    : center_(center), extents_(extents) {
+    : minimum_(center - extents), maximum_(center + extents) {
+}
+
+BoundingBox::BoundingBox(const glm::vec3 &minimum, const glm::vec3 &maximum)
+    : minimum_(minimum), maximum_(maximum) {
 }
 
 bool BoundingBox::intersectsWithSphere(const glm::vec3 &sphere,
@@ -32,14 +36,14 @@ bool BoundingBox::intersectsWithSphere(const glm::vec3 &sphere,
   for (int axis = 0; axis < 3; axis++) {
 
     // if sphere is "below" box
-    if (sphere[axis] < (center_[axis] - extents_)) {
-      s = sphere[axis] - (center_[axis] - extents_);
+    if (sphere[axis] < minimum_[axis]) {
+      s = sphere[axis] - minimum_[axis];
       distance += s * s;
     }
 
     // if sphere is "above" box
-    if (sphere[axis] > (center_[axis] + extents_)) {
-      s = sphere[axis] - (center_[axis] + extents_);
+    if (sphere[axis] > maximum_[axis]) {
+      s = sphere[axis] - maximum_[axis];
       distance += s * s;
     }
 
@@ -50,3 +54,11 @@ bool BoundingBox::intersectsWithSphere(const glm::vec3 &sphere,
   // instead. Returns True if sphere intersects with bounding box
   return distance <= radius * radius;
 }
+
+const glm::vec3 &BoundingBox::getMinimum() const {
+  return minimum_;
+}
+
+const glm::vec3 &BoundingBox::getMaximum() const {
+  return maximum_;
+}
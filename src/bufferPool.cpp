@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include "bufferPool.h"
+
+BufferPool::BufferPool() : buffer_(0), slotSize_(0), slotCount_(0) {
+}
+
+void BufferPool::create(const size_t &slotCount, const size_t &slotSize) {
+  cleanup();
+  slotCount_ = slotCount;
+  slotSize_ = slotSize;
+
+  // storage is allocated once, contents are set per slot later
+  glGenBuffers(1, &buffer_);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer_);
+  glBufferData(GL_ARRAY_BUFFER, slotCount_ * slotSize_, nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // hand out lowest slots first
+  freeSlots_.clear();
+  for (size_t slot = slotCount_; slot-- > 0;) {
+    freeSlots_.push_back(slot);
+  }
+}
+
+void BufferPool::cleanup() {
+  if (buffer_ != 0) {
+    glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+  }
+  freeSlots_.clear();
+  slotCount_ = 0;
+}
+
+int BufferPool::acquire() {
+  if (freeSlots_.empty()) {
+    std::cerr << "Error: no free slot in buffer pool" << std::endl;
+    return -1;
+  }
+  int slot = freeSlots_.back();
+  freeSlots_.pop_back();
+  return slot;
+}
+
+void BufferPool::release(const int &slot) {
+  if (slot >= 0 && static_cast<size_t>(slot) < slotCount_) {
+    freeSlots_.push_back(slot);
+  }
+}
+
+void BufferPool::update(const int &slot, const GLvoid *data,
+                        const size_t &size, const size_t &offset) {
+  if (slot < 0 || offset + size > slotSize_) {
+    std::cerr << "Error: data does not fit into buffer slot" << std::endl;
+    return;
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, buffer_);
+  glBufferSubData(GL_ARRAY_BUFFER, getSlotOffset(slot) + offset, size, data);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+GLuint BufferPool::getBuffer() {
+  return buffer_;
+}
+
+size_t BufferPool::getSlotOffset(const int &slot) {
+  return slot * slotSize_;
+}
+
+size_t BufferPool::getSlotSize() {
+  return slotSize_;
+}
+
+size_t BufferPool::getSlotCount() {
+  return slotCount_;
+}
+
+size_t BufferPool::getFreeCount() {
+  return freeSlots_.size();
+}
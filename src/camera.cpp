@@ -19,6 +19,8 @@
 
 #include "camera.h"
 
+#include <algorithm>
+
 Camera::Camera(glm::vec3 position, glm::vec3 up, GLfloat yaw, GLfloat pitch)
     : front_(glm::vec3(0.0f, 0.0f, -1.0f)),
       movementSpeed_(Defaults::Speed),
@@ -87,6 +89,14 @@ glm::vec3 Camera::getPosition() {
   return position_;
 }
 
+void Camera::setPose(const glm::vec3 &position, const GLfloat &yaw,
+                     const GLfloat &pitch) {
+  position_ = position;
+  yaw_ = yaw;
+  pitch_ = std::min(std::max(pitch, -89.0f), 89.0f);
+  updateCameraVectors();
+}
+
 void Camera::setMovementSpeed(const GLfloat &speed) {
   movementSpeed_ = speed;
 }
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cameraPath.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool CameraPath::load(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << "Error: can't read camera path " << path << std::endl;
+    return false;
+  }
+  return parse(file);
+}
+
+bool CameraPath::parse(std::istream &input) {
+  poses_.clear();
+  changes_.clear();
+
+  std::string line;
+  for (int number = 1; std::getline(input, line); number++) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    double time;
+    std::string command;
+    if (!(fields >> time)) {
+      // empty line or comment, unless there is anything but whitespace
+      if (line.find_first_not_of(" \t\r") == std::string::npos) {
+        continue;
+      }
+      std::cerr << "Error: camera path line " << number << ": no time"
+                << std::endl;
+      return false;
+    }
+
+    bool valid = static_cast<bool>(fields >> command);
+    if (valid && command == "camera") {
+      Pose pose;
+      pose.time = time;
+      valid = static_cast<bool>(fields >> pose.position.x >>
+                                pose.position.y >> pose.position.z >>
+                                pose.yaw >> pose.pitch);
+      poses_.push_back(pose);
+    } else if (valid && command == "algorithm") {
+      std::string name;
+      fields >> name;
+      int algorithm = NoiseInterface::parseAlgorithm(name);
+      valid = algorithm >= 0;
+      changes_.push_back(Change{time, command, static_cast<double>(algorithm)});
+    } else if (valid) {
+      // noise option, rejected if it is out of range, e.g. octaves 0, as
+      // libnoise would throw once it is applied
+      double value;
+      NoiseOptions options = PerlinNoise::getDefaultOptions();
+      valid = fields >> value &&
+              NoiseInterface::setOption(command, value, options);
+      changes_.push_back(Change{time, command, value});
+    }
+
+    std::string rest;
+    if (!valid || fields >> rest) {
+      std::cerr << "Error: camera path line " << number << ": invalid command "
+                << line << std::endl;
+      return false;
+    }
+  }
+
+  if (poses_.empty()) {
+    std::cerr << "Error: camera path has no camera pose" << std::endl;
+    return false;
+  }
+
+  // commands of the same time keep their order
+  std::stable_sort(
+      poses_.begin(), poses_.end(),
+      [](const Pose &a, const Pose &b) { return a.time < b.time; });
+  std::stable_sort(
+      changes_.begin(), changes_.end(),
+      [](const Change &a, const Change &b) { return a.time < b.time; });
+  return true;
+}
+
+CameraPath::Pose CameraPath::getPose(const double &time) const {
+  // first pose after time
+  auto next = std::upper_bound(
+      poses_.begin(), poses_.end(), time,
+      [](const double &time, const Pose &pose) { return time < pose.time; });
+  if (next == poses_.begin()) {
+    return poses_.front();
+  }
+  if (next == poses_.end()) {
+    return poses_.back();
+  }
+
+  const Pose &previous = *(next - 1);
+  float t = (time - previous.time) / (next->time - previous.time);
+  Pose pose;
+  pose.time = time;
+  pose.position = glm::mix(previous.position, next->position, t);
+  pose.yaw = previous.yaw + (next->yaw - previous.yaw) * t;
+  pose.pitch = previous.pitch + (next->pitch - previous.pitch) * t;
+  return pose;
+}
+
+std::vector<CameraPath::Change>
+CameraPath::getChanges(const double &from, const double &to) const {
+  std::vector<Change> changes;
+  for (const Change &change : changes_) {
+    if (change.time >= from && change.time < to) {
+      changes.push_back(change);
+    }
+  }
+  return changes;
+}
+
+double CameraPath::getDuration() const {
+  double duration = poses_.empty() ? 0.0 : poses_.back().time;
+  if (!changes_.empty()) {
+    duration = std::max(duration, changes_.back().time);
+  }
+  return duration;
+}
+
+bool CameraPath::applyOption(const Change &change, NoiseOptions &options) {
+  return NoiseInterface::setOption(change.name, change.value, options);
+}
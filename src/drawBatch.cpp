@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "drawBatch.h"
+
+void DrawBatch::clear() {
+  counts_.clear();
+  offsets_.clear();
+  baseVertices_.clear();
+}
+
+void DrawBatch::add(const GLsizei &count, const GLuint &firstIndex,
+                    const GLint &baseVertex) {
+  // visible neighbouring quadtree nodes are consecutive in the index buffer
+  if (!counts_.empty() && baseVertices_.back() == baseVertex &&
+      reinterpret_cast<size_t>(offsets_.back()) / sizeof(GLuint) +
+              counts_.back() ==
+          firstIndex) {
+    counts_.back() += count;
+    return;
+  }
+
+  counts_.push_back(count);
+  offsets_.push_back(
+      reinterpret_cast<const GLvoid *>(firstIndex * sizeof(GLuint)));
+  baseVertices_.push_back(baseVertex);
+}
+
+void DrawBatch::draw() {
+  if (counts_.empty()) {
+    return;
+  }
+  // core since OpenGL 3.2
+  glMultiDrawElementsBaseVertex(GL_TRIANGLES, &counts_.front(),
+                                GL_UNSIGNED_INT, &offsets_.front(),
+                                counts_.size(), &baseVertices_.front());
+}
+
+size_t DrawBatch::size() {
+  return counts_.size();
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frameReport.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+void FrameReport::addSetting(const std::string &name,
+                             const std::string &value) {
+  settings_.push_back(name + ": " + value);
+}
+
+void FrameReport::addFrame(const double &time, const float &frameTime,
+                           const size_t &requestedTiles,
+                           const size_t &appliedTiles,
+                           const std::vector<Profiler::Stage> &stages) {
+  Frame frame{time, frameTime, requestedTiles, appliedTiles,
+              std::vector<float>()};
+  // profiler only ever appends stages, so their order stays the same
+  for (size_t i = 0; i < stages.size(); i++) {
+    const Profiler::Stage &stage = stages[i];
+    if (i == stageNames_.size()) {
+      stageNames_.push_back(stage.name);
+    }
+    size_t last = (stage.offset + stage.history.size() - 1) %
+                  stage.history.size();
+    frame.stageTimes.push_back(stage.history[last]);
+  }
+  frames_.push_back(frame);
+}
+
+size_t FrameReport::getFrameCount() {
+  return frames_.size();
+}
+
+bool FrameReport::write(const std::string &path) {
+  std::ofstream file(path, std::ios::trunc);
+  for (const std::string &setting : settings_) {
+    file << "# " << setting << "\n";
+  }
+  file << "frame,time,frame_ms,tiles_requested,tiles_applied";
+  for (const std::string &name : stageNames_) {
+    file << ",\"" << name << "\"";
+  }
+  file << "\n";
+
+  char line[128];
+  for (size_t i = 0; i < frames_.size(); i++) {
+    const Frame &frame = frames_[i];
+    std::snprintf(line, sizeof(line), "%zu,%.4f,%.3f,%zu,%zu", i, frame.time,
+                  frame.frameTime, frame.requestedTiles, frame.appliedTiles);
+    file << line;
+    // stages which appeared later are empty in earlier frames
+    for (size_t stage = 0; stage < stageNames_.size(); stage++) {
+      file << ",";
+      if (stage < frame.stageTimes.size()) {
+        std::snprintf(line, sizeof(line), "%.3f", frame.stageTimes[stage]);
+        file << line;
+      }
+    }
+    file << "\n";
+  }
+
+  if (!file) {
+    std::cerr << "Error: can't write report " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void FrameReport::writeSummary(std::ostream &out) {
+  for (const std::string &setting : settings_) {
+    out << setting << std::endl;
+  }
+  if (frames_.empty()) {
+    out << "0 frames" << std::endl;
+    return;
+  }
+  std::vector<float> sorted;
+  double sum = 0.0;
+  for (const Frame &frame : frames_) {
+    sorted.push_back(frame.frameTime);
+    sum += frame.frameTime;
+  }
+  std::sort(sorted.begin(), sorted.end());
+
+  char line[160];
+  std::snprintf(line, sizeof(line),
+                "%zu frames, ms/frame: mean %.2f, p50 %.2f, p95 %.2f, "
+                "p99 %.2f, max %.2f",
+                frames_.size(), sum / frames_.size(),
+                Profiler::percentile(sorted, 0.5f),
+                Profiler::percentile(sorted, 0.95f),
+                Profiler::percentile(sorted, 0.99f), sorted.back());
+  out << line << std::endl;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frustum.h"
+
+Frustum::Frustum() {
+  // d is so large that every point is on the inner side
+  for (glm::vec4 &plane : planes_) {
+    plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+  }
+}
+
+Frustum::Frustum(const glm::mat4 &viewProjection) {
+  // see Gribb, Hartmann: Fast Extraction of Viewing Frustum Planes from the
+  // World-View-Projection Matrix. glm matrices are column major, so row i is
+  // m[0][i], m[1][i], m[2][i], m[3][i]
+  glm::vec4 rows[4];
+  for (int i = 0; i < 4; i++) {
+    rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i],
+                        viewProjection[2][i], viewProjection[3][i]);
+  }
+
+  // left, right, bottom, top, near, far
+  planes_[0] = rows[3] + rows[0];
+  planes_[1] = rows[3] - rows[0];
+  planes_[2] = rows[3] + rows[1];
+  planes_[3] = rows[3] - rows[1];
+  planes_[4] = rows[3] + rows[2];
+  planes_[5] = rows[3] - rows[2];
+
+  for (glm::vec4 &plane : planes_) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+}
+
+Frustum::Result Frustum::classify(const BoundingBox &box) const {
+  const glm::vec3 &minimum = box.getMinimum();
+  const glm::vec3 &maximum = box.getMaximum();
+  Result result = Inside;
+
+  for (const glm::vec4 &plane : planes_) {
+    // corners of box farthest along and against plane normal
+    glm::vec3 positive = minimum;
+    glm::vec3 negative = maximum;
+    for (int axis = 0; axis < 3; axis++) {
+      if (plane[axis] >= 0) {
+        positive[axis] = maximum[axis];
+        negative[axis] = minimum[axis];
+      }
+    }
+
+    if (glm::dot(glm::vec3(plane), positive) + plane.w < 0) {
+      return Outside;
+    }
+    if (glm::dot(glm::vec3(plane), negative) + plane.w < 0) {
+      result = Intersects;
+    }
+  }
+  return result;
+}
@@ -25,11 +25,39 @@ Game::Game()
       guiClosed_(false),
       leftMouseBtnPressed_(false),
       tileManager_(std::unique_ptr<TileManager>(new TileManager)),
-      currentPos_(Defaults::CameraPosition) {
+      storeDirectory_(Defaults::TileStoreDirectory),
+      currentPos_(Defaults::CameraPosition),
+      frameTimes_(Defaults::FrameTimeHistory, 0.0f),
+      frameTimesOffset_(0),
+      terrainGpuTimer_("GPU TileManager::renderAll"),
+      guiGpuTimer_("GPU ImGui::Render"),
+      replayTimestep_(Defaults::ReplayTimestep),
+      replayTime_(0.0) {
   camera_ = Camera(
       glm::vec3(currentPos_.x, 3.5 * Defaults::TileWidth, currentPos_.z));
 }
 
+void Game::setReplay(const std::shared_ptr<const CameraPath> &path,
+                     const std::string &reportPath, const float &timestep) {
+  replayPath_ = path;
+  reportPath_ = reportPath;
+  replayTimestep_ = timestep;
+  replayTime_ = 0.0;
+  // gui is not part of the measured workload, toggle it with <TAB>
+  guiClosed_ = true;
+  // tiles loaded from a store filled by earlier runs would make every run
+  // a different workload
+  storeDirectory_.clear();
+
+  CameraPath::Pose pose = path->getPose(0.0);
+  camera_.setPose(pose.position, pose.yaw, pose.pitch);
+  currentPos_ = pose.position;
+}
+
+void Game::setTileStore(const std::string &directory) {
+  storeDirectory_ = directory;
+}
+
 int Game::run() {
   // Initialize
   if (!initializeGlfw()) {
@@ -39,7 +67,20 @@ int Game::run() {
     return 2;
   }
   initializeGl();
-  tileManager_->initialize(currentPos_);
+  if (replayPath_) {
+    // frame rate is not limited by vertical sync
+    glfwSwapInterval(0);
+  }
+  Profiler &profiler = Profiler::getShared();
+  profiler.nameThread("Main");
+  profiler.setEnabled(true);
+  terrainGpuTimer_.setup();
+  guiGpuTimer_.setup();
+  tileManager_->initialize(currentPos_, storeDirectory_);
+  if (replayPath_) {
+    report_.addSetting("tile store",
+                       storeDirectory_.empty() ? "off" : storeDirectory_);
+  }
   options_ = tileManager_->getOptions();
   ImGui_ImplGlfwGL3_Init(window_, true);
 
@@ -54,15 +95,35 @@ int Game::run() {
     GLfloat currentTime = glfwGetTime();
     deltaTime_ = currentTime - lastFrame_;
     lastFrame_ = currentTime;
+    recordFrameTime(deltaTime_);
+
+    // every replay renders the same frames, no matter how long they take
+    size_t requestedTiles = tileManager_->getRequestedTiles();
+    size_t appliedTiles = tileManager_->getAppliedTiles();
+    if (replayPath_) {
+      if (replayTime_ > replayPath_->getDuration()) {
+        break;
+      }
+      deltaTime_ = replayTimestep_;
+      replayPath();
+    }
 
     // Check for events
-    glfwPollEvents();
+    {
+      ScopedTimer timer("glfwPollEvents");
+      glfwPollEvents();
+    }
 
     // GUI
-    showGui();
+    {
+      ScopedTimer timer("Game::showGui");
+      showGui();
+    }
 
     // Move
-    do_movement(deltaTime_);
+    if (!replayPath_) {
+      do_movement(deltaTime_);
+    }
 
     // Get current camera position
     getCurrentPosition();
@@ -73,32 +134,77 @@ int Game::run() {
 
     // Update and render tiles
     tileManager_->update(currentPos_);
+    terrainGpuTimer_.begin();
     tileManager_->renderAll(deltaTime_, camera_.getViewMatrix());
+    terrainGpuTimer_.end();
 
     // Render GUI
     if (!guiClosed_) {
+      ScopedTimer timer("ImGui::Render");
+      guiGpuTimer_.begin();
       // ignore wireframe setting for gui
       glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
       ImGui::Render();
       glPolygonMode(GL_FRONT_AND_BACK, fillmode_);
+      guiGpuTimer_.end();
     }
 
     // Swap the screen buffers
-    glfwSwapBuffers(window_);
+    {
+      ScopedTimer timer("glfwSwapBuffers");
+      glfwSwapBuffers(window_);
+    }
+
+    // GPU times of earlier frames
+    terrainGpuTimer_.collect();
+    guiGpuTimer_.collect();
+    profiler.endFrame();
+
+    if (replayPath_) {
+      report_.addFrame(replayTime_, 1000.0 * (glfwGetTime() - currentTime),
+                       tileManager_->getRequestedTiles() - requestedTiles,
+                       tileManager_->getAppliedTiles() - appliedTiles,
+                       profiler.getStages());
+      replayTime_ += replayTimestep_;
+    }
   }
 
   // Clean up imgui
   ImGui_ImplGlfwGL3_Shutdown();
 
-  // Clean up tiles
+  // Clean up tiles and queries
   tileManager_->cleanUp();
+  terrainGpuTimer_.cleanup();
+  guiGpuTimer_.cleanup();
 
   // Terminate GLFW, clearing any resources allocated by GLFW.
   glfwDestroyWindow(window_);
   glfwTerminate();
+
+  if (replayPath_) {
+    report_.writeSummary(std::cout);
+    if (!report_.write(reportPath_)) {
+      return 3;
+    }
+  }
   return 0;
 }
 
+void Game::replayPath() {
+  CameraPath::Pose pose = replayPath_->getPose(replayTime_);
+  camera_.setPose(pose.position, pose.yaw, pose.pitch);
+
+  for (const CameraPath::Change &change :
+       replayPath_->getChanges(replayTime_, replayTime_ + replayTimestep_)) {
+    if (change.name == "algorithm") {
+      tileManager_->setTileAlgorithm(static_cast<int>(change.value));
+      options_ = tileManager_->getOptions();
+    } else if (CameraPath::applyOption(change, options_)) {
+      tileManager_->setTileAlgorithmOptions(options_);
+    }
+  }
+}
+
 void Game::do_movement(const GLfloat &deltaTime) {
   // Camera keyboard controls
   if (keys_[GLFW_KEY_W]) {
@@ -254,8 +360,67 @@ void Game::initializeGl() {
 
 void Game::getCurrentPosition() {
   /* previousPos_ = currentPos_; */
-  currentPos_.x = camera_.getPosition().x;
-  currentPos_.z = camera_.getPosition().z;
+  currentPos_ = camera_.getPosition();
+}
+
+void Game::recordFrameTime(const GLfloat &deltaTime) {
+  frameTimes_[frameTimesOffset_] = 1000.0f * deltaTime;
+  frameTimesOffset_ = (frameTimesOffset_ + 1) % frameTimes_.size();
+}
+
+void Game::showFrameTimes() {
+  // frame times of last frames in order of occurrence
+  float maxTime = *std::max_element(frameTimes_.begin(), frameTimes_.end());
+  char overlay[32];
+  snprintf(overlay, sizeof(overlay), "max %.1f ms", maxTime);
+  ImGui::PlotLines("ms/frame", &frameTimes_.front(), frameTimes_.size(),
+                   frameTimesOffset_, overlay, 0.0f, 50.0f, ImVec2(0, 60));
+
+  // histogram of frame times in buckets of 2 ms. Last bucket collects all
+  // frames slower than 50 ms. A stall when crossing a tile border shows up as
+  // outliers on the right side
+  static const int bucketCount = 26;
+  static const float bucketWidth = 2.0f;
+  float buckets[bucketCount] = {0};
+  for (float frameTime : frameTimes_) {
+    int bucket = std::min(static_cast<int>(frameTime / bucketWidth),
+                          bucketCount - 1);
+    buckets[bucket]++;
+  }
+  ImGui::PlotHistogram("histogram", buckets, bucketCount, 0, "0 - 50+ ms",
+                       0.0f, FLT_MAX, ImVec2(0, 60));
+}
+
+void Game::showProfiler() {
+  Profiler &profiler = Profiler::getShared();
+  bool enabled = profiler.isEnabled();
+  if (ImGui::Checkbox("Profile stages", &enabled)) {
+    profiler.setEnabled(enabled);
+  }
+
+  // ms per frame of each stage. Stages of worker threads are summed over
+  // all workers, GPU stages lag a few frames behind
+  for (const Profiler::Stage &stage : profiler.getStages()) {
+    char overlay[96];
+    snprintf(overlay, sizeof(overlay),
+             "p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", stage.median,
+             stage.p95, stage.p99, stage.maximum);
+    ImGui::PlotLines(stage.name.c_str(), &stage.history.front(),
+                     stage.history.size(), stage.offset, overlay, 0.0f,
+                     std::max(stage.maximum, 1.0f), ImVec2(0, 40));
+  }
+
+  // chrome://tracing or ui.perfetto.dev show the trace file
+  if (profiler.isTracing()) {
+    ImGui::Text("Recording trace...");
+  } else if (ImGui::Button("Record trace")) {
+    profiler.setEnabled(true);
+    profiler.startTrace("trace.json");
+  }
+  std::string tracePath = profiler.getTracePath();
+  if (!tracePath.empty()) {
+    ImGui::Text("Last trace: %s", tracePath.c_str());
+  }
 }
 
 void Game::toggleGui() {
@@ -288,6 +453,14 @@ void Game::showGui() {
   ImGui::Text("Avg %.3f ms/frame (%.1f FPS)",
               1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
 
+  if (ImGui::CollapsingHeader("Frame times")) {
+    showFrameTimes();
+  }
+
+  if (ImGui::CollapsingHeader("Profiler")) {
+    showProfiler();
+  }
+
   // Show current tile
   int xTile = std::floor(currentPos_.x / Defaults::TileWidth);
   int zTile = std::floor(currentPos_.z / Defaults::TileWidth);
@@ -304,6 +477,52 @@ void Game::showGui() {
   if (ImGui::CollapsingHeader("Map Options")) {
     bool showSea = tileManager_->getShowSea();
     float seaLevel = tileManager_->getSeaLevel();
+    int viewRadius = tileManager_->getViewRadius();
+
+    bool lodEnabled = tileManager_->getLodEnabled();
+
+    if (ImGui::SliderInt("View radius", &viewRadius, 1,
+                         Defaults::MaximumViewRadius)) {
+      tileManager_->setViewRadius(viewRadius);
+    }
+
+    if (ImGui::Checkbox("Level of detail", &lodEnabled)) {
+      tileManager_->setLodEnabled(lodEnabled);
+    }
+    bool batched = tileManager_->getBatched();
+    if (ImGui::Checkbox("Batched rendering", &batched)) {
+      tileManager_->setBatched(batched);
+    }
+
+    bool heightmapMode = tileManager_->getHeightmapMode();
+    if (ImGui::Checkbox("Heightmap textures", &heightmapMode)) {
+      tileManager_->setHeightmapMode(heightmapMode);
+    }
+
+    bool cullingEnabled = tileManager_->getCullingEnabled();
+    if (ImGui::Checkbox("Frustum culling", &cullingEnabled)) {
+      tileManager_->setCullingEnabled(cullingEnabled);
+    }
+
+    ImGui::Text("Terrain triangles: %zu", tileManager_->getTriangleCount());
+    ImGui::Text("Tiles: %zu visible, %zu culled",
+                tileManager_->getVisibleTiles(),
+                tileManager_->getCulledTiles());
+    ImGui::Text("Patches: %zu visible, %zu culled",
+                tileManager_->getVisiblePatches(),
+                tileManager_->getCulledPatches());
+    ImGui::Text("Draw calls: %zu", tileManager_->getDrawCalls());
+    ImGui::Text("Tile cache: %zu hits, %zu misses, %zu tiles, %.1f MiB",
+                tileManager_->getCacheHits(), tileManager_->getCacheMisses(),
+                tileManager_->getCacheSize(),
+                tileManager_->getCacheBytes() / (1024.0f * 1024.0f));
+    if (tileManager_->getStoreEnabled()) {
+      ImGui::Text("Tile store: %zu hits, %zu misses, %.1f MiB",
+                  tileManager_->getStoreHits(), tileManager_->getStoreMisses(),
+                  tileManager_->getStoreBytes() / (1024.0f * 1024.0f));
+    } else {
+      ImGui::Text("Tile store: off");
+    }
 
     if (ImGui::Checkbox("Show sea", &showSea)) {
       tileManager_->setShowSea(showSea);
@@ -335,6 +554,8 @@ void Game::showGui() {
         (ImGui::RadioButton("Billow Noise", &algorithm, Defaults::Billow));
     btnPressed |=
         (ImGui::RadioButton("Random Noise", &algorithm, Defaults::Random));
+    btnPressed |= (ImGui::RadioButton("Mountains (Noise Graph)", &algorithm,
+                                      Defaults::Mountains));
 
     if (btnPressed) {
       tileManager_->setTileAlgorithm(algorithm);
@@ -345,8 +566,8 @@ void Game::showGui() {
     bool optsChanged = false;
 
     // TODO: better handling of available options for different algorithms
+    optsChanged |= (ImGui::InputInt("Seed", &options_.seed, 1));
     if (algorithm != Defaults::Random) {
-      optsChanged |= (ImGui::InputInt("Seed", &options_.seed, 1));
       optsChanged |=
           (ImGui::SliderFloat("Frequency", &options_.frequency, 1, 6));
       optsChanged |=
@@ -362,6 +583,15 @@ void Game::showGui() {
     if (optsChanged) {
       tileManager_->setTileAlgorithmOptions(options_);
     }
+
+    if (algorithm == Defaults::Perlin || algorithm == Defaults::Billow) {
+      bool layersEnabled = tileManager_->getLayersEnabled();
+      if (ImGui::Checkbox("Cache octave layers", &layersEnabled)) {
+        tileManager_->setLayersEnabled(layersEnabled);
+      }
+      ImGui::Text("Octave layers: %.1f MiB",
+                  tileManager_->getLayerBytes() / (1024.0f * 1024.0f));
+    }
   }
 
   ImGui::EndPopup();
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gpuTimer.h"
+
+GpuTimer::GpuTimer(const char *name, Profiler &profiler)
+    : name_(name),
+      profiler_(profiler),
+      queries_{0},
+      starts_{0.0},
+      pending_{false},
+      next_(0),
+      active_(false),
+      setUp_(false) {
+}
+
+void GpuTimer::setup() {
+  // core since OpenGL 3.3
+  glGenQueries(QueryCount, queries_);
+  setUp_ = true;
+}
+
+void GpuTimer::cleanup() {
+  if (setUp_) {
+    glDeleteQueries(QueryCount, queries_);
+    setUp_ = false;
+  }
+}
+
+void GpuTimer::begin() {
+  if (!setUp_ || active_ || pending_[next_] || !profiler_.isEnabled()) {
+    return;
+  }
+  starts_[next_] = profiler_.now();
+  glBeginQuery(GL_TIME_ELAPSED, queries_[next_]);
+  active_ = true;
+}
+
+void GpuTimer::end() {
+  if (!active_) {
+    return;
+  }
+  glEndQuery(GL_TIME_ELAPSED);
+  pending_[next_] = true;
+  next_ = (next_ + 1) % QueryCount;
+  active_ = false;
+}
+
+void GpuTimer::collect() {
+  for (int i = 0; i < QueryCount; i++) {
+    if (!pending_[i]) {
+      continue;
+    }
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(queries_[i], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+      continue;
+    }
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(queries_[i], GL_QUERY_RESULT, &nanoseconds);
+    profiler_.record(name_, starts_[i], nanoseconds / 1000.0,
+                     Profiler::GpuThread);
+    pending_[i] = false;
+  }
+}
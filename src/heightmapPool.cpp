@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include "heightmapPool.h"
+
+HeightmapPool::HeightmapPool() : texture_(0), width_(0), layerCount_(0) {
+}
+
+void HeightmapPool::create(const size_t &layerCount, const GLuint &width) {
+  cleanup();
+  width_ = width;
+  layerCount_ = layerCount;
+
+  // OpenGL 3.3 guarantees only 256 layers
+  GLint maximumLayers = 0;
+  glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maximumLayers);
+  if (layerCount_ > static_cast<size_t>(maximumLayers)) {
+    std::cerr << "Error: " << layerCount_ << " heightmaps exceed "
+              << maximumLayers << " texture layers" << std::endl;
+    layerCount_ = maximumLayers;
+  }
+
+  // heights are fetched per vertex without filtering
+  glGenTextures(1, &texture_);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, texture_);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R32F, width_, width_, layerCount_,
+               0, GL_RED, GL_FLOAT, nullptr);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+  // hand out lowest layers first
+  freeLayers_.clear();
+  for (size_t layer = layerCount_; layer-- > 0;) {
+    freeLayers_.push_back(layer);
+  }
+}
+
+void HeightmapPool::cleanup() {
+  if (texture_ != 0) {
+    glDeleteTextures(1, &texture_);
+    texture_ = 0;
+  }
+  freeLayers_.clear();
+  layerCount_ = 0;
+}
+
+int HeightmapPool::acquire() {
+  if (freeLayers_.empty()) {
+    std::cerr << "Error: no free layer in heightmap pool" << std::endl;
+    return -1;
+  }
+  int layer = freeLayers_.back();
+  freeLayers_.pop_back();
+  return layer;
+}
+
+void HeightmapPool::release(const int &layer) {
+  if (layer >= 0 && static_cast<size_t>(layer) < layerCount_) {
+    freeLayers_.push_back(layer);
+  }
+}
+
+void HeightmapPool::update(const int &layer, const GLfloat *heights) {
+  if (layer < 0 || static_cast<size_t>(layer) >= layerCount_) {
+    return;
+  }
+  glBindTexture(GL_TEXTURE_2D_ARRAY, texture_);
+  glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width_, width_, 1,
+                  GL_RED, GL_FLOAT, heights);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+GLuint HeightmapPool::getTexture() {
+  return texture_;
+}
+
+size_t HeightmapPool::getLayerCount() {
+  return layerCount_;
+}
+
+size_t HeightmapPool::getFreeCount() {
+  return freeLayers_.size();
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indexBuffer.h"
+
+GLuint IndexBuffer::buffer_ = 0;
+
+const IndexBuffer::Layout &IndexBuffer::getLayout() {
+  // initialization of local statics is thread-safe, so worker threads and
+  // render thread may ask for indices at the same time
+  static const Layout layout = createLayout();
+  return layout;
+}
+
+IndexBuffer::Layout IndexBuffer::createLayout() {
+  Layout layout;
+
+  for (int lod = 0; lod <= Defaults::MaximumLod; lod++) {
+    IndexSpan grid = Quadtree::getShared().getLevel(lod);
+    std::vector<GLuint> skirt = createSkirtIndices(lod, Defaults::TileWidth);
+
+    layout.offsets.push_back(layout.indices.size());
+    layout.gridCounts.push_back(grid.size());
+    layout.counts.push_back(grid.size() + skirt.size());
+    layout.indices.insert(layout.indices.end(), grid.begin(), grid.end());
+    layout.indices.insert(layout.indices.end(), skirt.begin(), skirt.end());
+  }
+
+  return layout;
+}
+
+const std::vector<GLuint> &IndexBuffer::getIndices() {
+  return getLayout().indices;
+}
+
+const Quadtree &IndexBuffer::getQuadtree() {
+  return Quadtree::getShared();
+}
+
+GLuint IndexBuffer::getOffset(const int &lod) {
+  return getLayout().offsets[lod];
+}
+
+GLuint IndexBuffer::getGridCount(const int &lod) {
+  return getLayout().gridCounts[lod];
+}
+
+GLuint IndexBuffer::getCount(const int &lod) {
+  return getLayout().counts[lod];
+}
+
+GLuint IndexBuffer::getNodeOffset(const size_t &node, const int &lod) {
+  // grid indices of a level are a copy of the quadtree level
+  const Quadtree &quadtree = getQuadtree();
+  IndexSpan nodeIndices = quadtree.getNodeIndices(node, lod);
+  return getOffset(lod) + (nodeIndices.data - quadtree.getLevel(lod).data);
+}
+
+GLuint IndexBuffer::getBuffer() {
+  if (buffer_ == 0) {
+    const std::vector<GLuint> &indices = getIndices();
+    glGenBuffers(1, &buffer_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint),
+                 &indices.front(), GL_STATIC_DRAW);
+  }
+  return buffer_;
+}
+
+void IndexBuffer::cleanup() {
+  if (buffer_ != 0) {
+    glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+  }
+}
+
+std::vector<GLuint> IndexBuffer::createSkirtIndices(const int &lod,
+                                                    const GLuint &tileWidth) {
+  // two triangles per border segment of this level of detail, facing away
+  // from the tile
+  GLuint width = tileWidth + 1;
+  GLuint skirtStart = width * width;
+  GLuint step = pow(2, Defaults::MaximumLod - lod);
+  std::vector<GLuint> indices;
+
+  for (GLuint i = 0; i < tileWidth; i += step) {
+    GLuint j = i + step;
+
+    // north and east edges are seen from -z and +x. Triangles are
+    // top(i)->top(j)->bottom(j) and top(i)->bottom(j)->bottom(i)
+    GLuint north[4] = {i, j, skirtStart + j, skirtStart + i};
+    GLuint east[4] = {i * width + tileWidth, j * width + tileWidth,
+                      skirtStart + 3 * width + j, skirtStart + 3 * width + i};
+
+    // south and west edges are seen from +z and -x and need the opposite
+    // winding: top(i)->bottom(i)->bottom(j) and top(i)->bottom(j)->top(j)
+    GLuint south[4] = {tileWidth * width + i, tileWidth * width + j,
+                       skirtStart + width + j, skirtStart + width + i};
+    GLuint west[4] = {i * width, j * width, skirtStart + 2 * width + j,
+                      skirtStart + 2 * width + i};
+
+    for (GLuint *quad : {north, east}) {
+      GLuint triangles[6] = {quad[0], quad[1], quad[2],
+                             quad[0], quad[2], quad[3]};
+      indices.insert(indices.end(), triangles, triangles + 6);
+    }
+    for (GLuint *quad : {south, west}) {
+      GLuint triangles[6] = {quad[0], quad[3], quad[2],
+                             quad[0], quad[2], quad[1]};
+      indices.insert(indices.end(), triangles, triangles + 6);
+    }
+  }
+
+  return indices;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "instanceBatch.h"
+
+InstanceBatch::InstanceBatch()
+    : groups_(Defaults::MaximumLod + 1), buffer_(0) {
+}
+
+void InstanceBatch::clear() {
+  for (auto &group : groups_) {
+    group.clear();
+  }
+}
+
+void InstanceBatch::add(const int &lod, const GLint &x, const GLint &z,
+                        const GLint &layer) {
+  TileInstance instance = {static_cast<GLfloat>(x), static_cast<GLfloat>(z),
+                           static_cast<GLfloat>(layer)};
+  groups_[lod].push_back(instance);
+}
+
+void InstanceBatch::upload() {
+  // groups are stored back to back
+  std::vector<TileInstance> instances;
+  for (auto &group : groups_) {
+    instances.insert(instances.end(), group.begin(), group.end());
+  }
+  if (instances.empty()) {
+    return;
+  }
+
+  if (buffer_ == 0) {
+    glGenBuffers(1, &buffer_);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, buffer_);
+  glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(TileInstance),
+               &instances.front(), GL_STREAM_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBatch::draw(bool gridOnly) {
+  glBindBuffer(GL_ARRAY_BUFFER, buffer_);
+  size_t first = 0;
+  for (size_t lod = 0; lod < groups_.size(); lod++) {
+    if (groups_[lod].empty()) {
+      continue;
+    }
+    // instanced draws with base instance need OpenGL 4.2, so point attribute
+    // at first instance of group instead
+    glVertexAttribPointer(
+        Attribute, 3, GL_FLOAT, GL_FALSE, sizeof(TileInstance),
+        reinterpret_cast<GLvoid *>(first * sizeof(TileInstance)));
+
+    GLsizei count = gridOnly ? IndexBuffer::getGridCount(lod)
+                             : IndexBuffer::getCount(lod);
+    GLvoid *offset = reinterpret_cast<GLvoid *>(IndexBuffer::getOffset(lod) *
+                                                sizeof(GLuint));
+    glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, offset,
+                            groups_[lod].size());
+    first += groups_[lod].size();
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBatch::cleanup() {
+  if (buffer_ != 0) {
+    glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+  }
+}
+
+size_t InstanceBatch::getGroupCount() {
+  size_t count = 0;
+  for (auto &group : groups_) {
+    if (!group.empty()) {
+      count++;
+    }
+  }
+  return count;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "layerCache.h"
+
+LayerCache::LayerCache(const size_t &maximumBytes)
+    : maximumBytes_(maximumBytes), bytes_(0), hits_(0), misses_(0) {
+}
+
+TileKey LayerCache::layerKey(const NoiseInterface &noise, const int &x,
+                             const int &z) {
+  TileKey key(noise, x, z);
+  key.options.persistence = 0.0f;
+  key.options.octaveCount = 0;
+  return key;
+}
+
+bool LayerCache::fillHeights(const NoiseInterface &noise, const int &x,
+                             const int &z, const int &width, float *out) {
+  if (!noise.hasLayers() || getMaximumBytes() == 0) {
+    return false;
+  }
+
+  TileKey key = layerKey(noise, x, z);
+  int octaveCount = noise.getOptions().octaveCount;
+  size_t count = width * width;
+  std::shared_ptr<const Layers> layers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = entries_.find(key.hash());
+    if (entry != entries_.end() && entry->second.key == key &&
+        entry->second.layers->width == width) {
+      layers = entry->second.layers;
+      usage_.splice(usage_.begin(), usage_, entry->second.position);
+    }
+  }
+
+  if (layers && layers->octaveCount >= octaveCount) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hits_++;
+  } else {
+    // cached layers are shared with other jobs, so they are extended in a
+    // copy. Only octaves missing from cached layers are generated
+    std::shared_ptr<Layers> extended(new Layers);
+    int firstOctave = layers ? layers->octaveCount : 0;
+    extended->octaveCount = octaveCount;
+    extended->width = width;
+    extended->values.resize(octaveCount * count);
+    if (layers) {
+      std::copy(layers->values.begin(), layers->values.end(),
+                extended->values.begin());
+    }
+    noise.fillLayers(x * Defaults::TileWidth, z * Defaults::TileWidth, width,
+                     firstOctave, &extended->values.front());
+    layers = extended;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    misses_++;
+    insert(key, layers);
+  }
+
+  noise.combineLayers(&layers->values.front(), count, out);
+  return true;
+}
+
+void LayerCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  usage_.clear();
+  entries_.clear();
+  bytes_ = 0;
+}
+
+void LayerCache::setMaximumBytes(const size_t &maximumBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  maximumBytes_ = maximumBytes;
+  evict();
+}
+
+size_t LayerCache::getMaximumBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return maximumBytes_;
+}
+
+size_t LayerCache::getBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+size_t LayerCache::getHits() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+size_t LayerCache::getMisses() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+void LayerCache::insert(const TileKey &key,
+                        const std::shared_ptr<const Layers> &layers) {
+  uint64_t hash = key.hash();
+  size_t bytes = layers->values.size() * sizeof(double);
+  auto entry = entries_.find(hash);
+  if (entry != entries_.end()) {
+    // keep more octaves, if another job extended the layers meanwhile
+    if (entry->second.key == key &&
+        entry->second.layers->width == layers->width &&
+        entry->second.layers->octaveCount > layers->octaveCount) {
+      return;
+    }
+    bytes_ -= entry->second.layers->values.size() * sizeof(double);
+    entry->second.key = key;
+    entry->second.layers = layers;
+    usage_.splice(usage_.begin(), usage_, entry->second.position);
+  } else {
+    usage_.push_front(hash);
+    entries_.insert(std::make_pair(hash, Entry{key, layers, usage_.begin()}));
+  }
+  bytes_ += bytes;
+  evict();
+}
+
+void LayerCache::evict() {
+  while (bytes_ > maximumBytes_ && !usage_.empty()) {
+    auto entry = entries_.find(usage_.back());
+    bytes_ -= entry->second.layers->values.size() * sizeof(double);
+    entries_.erase(entry);
+    usage_.pop_back();
+  }
+}
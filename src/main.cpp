@@ -17,10 +17,62 @@
  * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+
+#include "arguments.h"
 #include "game.h"
 
-int main() {
+static const char Usage[] =
+    "Usage: litlanes [options]\n"
+    "  --replay=<path>      fly along camera path and quit at its end\n"
+    "  --report=<path>      timings of every replayed frame, default\n"
+    "                       report.csv\n"
+    "  --timestep=<s>       time between replayed frames, default 1/60\n"
+    "  --tilecache=<dir>    directory of generated tiles, default tilecache,\n"
+    "                       none when replaying\n"
+    "  --no-tilecache       don't keep generated tiles on disk\n";
+
+int main(int argc, char **argv) {
+  std::string replay;
+  std::string report = "report.csv";
+  float timestep = Defaults::ReplayTimestep;
+  std::string tilecache = Defaults::TileStoreDirectory;
+  bool tilecacheSet = false;
+  for (int i = 1; i < argc; i++) {
+    const char *value = nullptr;
+    double number = 0.0;
+    if ((value = Arguments::getValue(argv[i], "--replay"))) {
+      replay = value;
+    } else if ((value = Arguments::getValue(argv[i], "--report"))) {
+      report = value;
+    } else if ((value = Arguments::getValue(argv[i], "--timestep")) &&
+               Arguments::parseNumber(value, number) && number > 0.0) {
+      timestep = number;
+    } else if ((value = Arguments::getValue(argv[i], "--tilecache")) &&
+               *value) {
+      tilecache = value;
+      tilecacheSet = true;
+    } else if (std::strcmp(argv[i], "--no-tilecache") == 0) {
+      tilecache.clear();
+      tilecacheSet = true;
+    } else {
+      std::cerr << "Error: invalid argument " << argv[i] << "\n" << Usage;
+      return 1;
+    }
+  }
+
   Game game;
+  if (!replay.empty()) {
+    std::shared_ptr<CameraPath> path(new CameraPath);
+    if (!path->load(replay)) {
+      return 1;
+    }
+    game.setReplay(path, report, timestep);
+  }
+  // replays run without store, unless it is given explicitly
+  if (replay.empty() || tilecacheSet) {
+    game.setTileStore(tilecache);
+  }
   int ret = game.run();
   return ret;
 }
@@ -19,102 +19,444 @@
 
 #include "noise.h"
 
-NoiseOptions NoiseInterface::getOptions() {
+#include <algorithm>
+#include <cmath>
+
+NoiseInterface::NoiseInterface(const NoiseOptions &options)
+    : options_(options) {
+}
+
+NoiseOptions NoiseInterface::getOptions() const {
   return options_;
 }
 
+std::shared_ptr<const NoiseInterface>
+NoiseInterface::create(const int &algorithm) {
+  switch (algorithm) {
+  case Defaults::Perlin:
+    return std::shared_ptr<const NoiseInterface>(new PerlinNoise);
+  case Defaults::RidgedMulti:
+    return std::shared_ptr<const NoiseInterface>(new RidgedMultiNoise);
+  case Defaults::Billow:
+    return std::shared_ptr<const NoiseInterface>(new BillowNoise);
+  case Defaults::Random:
+    return std::shared_ptr<const NoiseInterface>(new RandomNoise);
+  case Defaults::Mountains:
+    return std::shared_ptr<const NoiseInterface>(new MountainNoise);
+  default:
+    std::cerr << "Error: unknown algorithm " << algorithm << std::endl;
+    return std::shared_ptr<const NoiseInterface>(new PerlinNoise);
+  }
+}
+
+int NoiseInterface::parseAlgorithm(const std::string &name) {
+  static const char *names[] = {"perlin", "ridgedmulti", "billow", "random",
+                                "mountains"};
+  static const int algorithms[] = {Defaults::Perlin, Defaults::RidgedMulti,
+                                   Defaults::Billow, Defaults::Random,
+                                   Defaults::Mountains};
+  for (int i = 0; i < 5; i++) {
+    if (name == names[i]) {
+      return algorithms[i];
+    }
+  }
+  return -1;
+}
+
+bool NoiseInterface::setOption(const std::string &name, const double &value,
+                               NoiseOptions &options) {
+  // libnoise modules share the same maximum octave count
+  bool finite = std::isfinite(static_cast<float>(value));
+  bool integer = value == std::floor(value);
+  if (name == "frequency" && finite && value > 0.0) {
+    options.frequency = value;
+  } else if (name == "lacunarity" && finite && value >= 0.0) {
+    options.lacunarity = value;
+  } else if (name == "octaves" && integer && value >= 1 &&
+             value <= noise::module::PERLIN_MAX_OCTAVE) {
+    options.octaveCount = value;
+  } else if (name == "persistence" && finite) {
+    options.persistence = value;
+  } else if (name == "seed" && integer &&
+             value >= std::numeric_limits<int>::min() &&
+             value <= std::numeric_limits<int>::max()) {
+    options.seed = value;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 float NoiseInterface::applyResolution(const float &input) {
   return input / Defaults::Resolution;
 }
 
+void NoiseInterface::fillHeights(const int &xOffset, const int &zOffset,
+                                 const int &columns, const int &rows,
+                                 const int &stride, float *out) const {
+  for (int row = 0; row < rows; row++) {
+    for (int column = 0; column < columns; column++) {
+      out[row * stride + column] =
+          getValue(xOffset + column, 0.0f, zOffset + row);
+    }
+  }
+}
+
+bool NoiseInterface::hasLayers() const {
+  return false;
+}
+
+void NoiseInterface::fillLayers(const int & /* xOffset */,
+                                const int & /* zOffset */,
+                                const int & /* width */,
+                                const int & /* firstOctave */,
+                                double * /* layers */) const {
+  // only called if hasLayers()
+}
+
+void NoiseInterface::combineLayers(const double * /* layers */,
+                                   const int & /* count */,
+                                   float * /* out */) const {
+  // only called if hasLayers()
+}
+
+std::vector<double> NoiseInterface::sampleCoordinates(const int &offset,
+                                                      const int &count) {
+  // rounded to float first, exactly like coordinates passed to getValue()
+  std::vector<double> coordinates(count);
+  for (int i = 0; i < count; i++) {
+    coordinates[i] = applyResolution(offset + i);
+  }
+  return coordinates;
+}
+
 // Perlin
 
-PerlinNoise::PerlinNoise() {
-  noise_ = std::shared_ptr<noise::module::Perlin>(new noise::module::Perlin);
-  initializeOptions();
+PerlinNoise::PerlinNoise(const NoiseOptions &options)
+    : NoiseInterface(options) {
+  // module is configured once and only read afterwards
+  noise::module::Perlin *module = new noise::module::Perlin;
+  module->SetFrequency(options_.frequency);
+  module->SetLacunarity(options_.lacunarity);
+  module->SetOctaveCount(options_.octaveCount);
+  module->SetPersistence(options_.persistence);
+  module->SetSeed(options_.seed);
+  noise_ = std::shared_ptr<const noise::module::Perlin>(module);
+  octaves_ = NoiseKernel::octavesOf(*noise_);
+}
+
+NoiseOptions PerlinNoise::getDefaultOptions() {
+  NoiseOptions options;
+  options.frequency = noise::module::DEFAULT_PERLIN_FREQUENCY;
+  options.lacunarity = noise::module::DEFAULT_PERLIN_LACUNARITY;
+  options.octaveCount = noise::module::DEFAULT_PERLIN_OCTAVE_COUNT;
+  options.persistence = noise::module::DEFAULT_PERLIN_PERSISTENCE;
+  options.seed = noise::module::DEFAULT_PERLIN_SEED;
+  return options;
 }
 
-void PerlinNoise::initializeOptions() {
-  options_.frequency = noise::module::DEFAULT_PERLIN_FREQUENCY;
-  options_.lacunarity = noise::module::DEFAULT_PERLIN_LACUNARITY;
-  options_.octaveCount = noise::module::DEFAULT_PERLIN_OCTAVE_COUNT;
-  options_.persistence = noise::module::DEFAULT_PERLIN_PERSISTENCE;
-  options_.seed = noise::module::DEFAULT_PERLIN_SEED;
+std::shared_ptr<const NoiseInterface>
+PerlinNoise::withOptions(const NoiseOptions &options) const {
+  return std::shared_ptr<const NoiseInterface>(new PerlinNoise(options));
 }
 
-void PerlinNoise::setOptions(const NoiseOptions &options) {
-  options_ = options;
-  noise_->SetFrequency(options_.frequency);
-  noise_->SetLacunarity(options_.lacunarity);
-  noise_->SetOctaveCount(options_.octaveCount);
-  noise_->SetPersistence(options_.persistence);
-  noise_->SetSeed(options_.seed);
+int PerlinNoise::getAlgorithm() const {
+  return Defaults::Perlin;
 }
 
-GLfloat PerlinNoise::getValue(const float &x, const float &y, const float &z) {
+float PerlinNoise::getValue(const float &x, const float &y,
+                            const float &z) const {
+  // terrain lies in the plane y = 0, where the cheaper 2D kernel applies
+  if (y == 0.0f) {
+    return NoiseKernel::perlin(octaves_, applyResolution(x),
+                               applyResolution(z));
+  }
   return noise_->GetValue(applyResolution(x), y, applyResolution(z));
 }
 
+void PerlinNoise::fillHeights(const int &xOffset, const int &zOffset,
+                              const int &columns, const int &rows,
+                              const int &stride, float *out) const {
+  std::vector<double> x = sampleCoordinates(xOffset, columns);
+  std::vector<double> z = sampleCoordinates(zOffset, rows);
+  for (int row = 0; row < rows; row++) {
+    NoiseKernel::perlin(octaves_, &x.front(), z[row], columns,
+                        out + row * stride);
+  }
+}
+
+bool PerlinNoise::hasLayers() const {
+  return true;
+}
+
+void PerlinNoise::fillLayers(const int &xOffset, const int &zOffset,
+                             const int &width, const int &firstOctave,
+                             double *layers) const {
+  std::vector<double> x = sampleCoordinates(xOffset, width);
+  std::vector<double> z = sampleCoordinates(zOffset, width);
+  for (int row = 0; row < width; row++) {
+    NoiseKernel::perlinLayers(octaves_, firstOctave, &x.front(), z[row],
+                              width, width * width, layers + row * width);
+  }
+}
+
+void PerlinNoise::combineLayers(const double *layers, const int &count,
+                                float *out) const {
+  NoiseKernel::combineLayers(octaves_.persistence, octaves_.octaveCount, 0.0,
+                             layers, count, out);
+}
+
 // RidgedMulti
 
-RidgedMultiNoise::RidgedMultiNoise() {
-  noise_ = std::shared_ptr<noise::module::RidgedMulti>(
-      new noise::module::RidgedMulti);
-  initializeOptions();
+RidgedMultiNoise::RidgedMultiNoise(const NoiseOptions &options)
+    : NoiseInterface(options) {
+  // module is configured once and only read afterwards
+  noise::module::RidgedMulti *module = new noise::module::RidgedMulti;
+  module->SetFrequency(options_.frequency);
+  module->SetLacunarity(options_.lacunarity);
+  module->SetOctaveCount(options_.octaveCount);
+  module->SetSeed(options_.seed);
+  noise_ = std::shared_ptr<const noise::module::RidgedMulti>(module);
+  octaves_ = NoiseKernel::octavesOf(*noise_);
 }
 
-void RidgedMultiNoise::initializeOptions() {
-  options_.frequency = noise::module::DEFAULT_RIDGED_FREQUENCY;
-  options_.lacunarity = noise::module::DEFAULT_RIDGED_LACUNARITY;
-  options_.octaveCount = noise::module::DEFAULT_RIDGED_OCTAVE_COUNT;
-  options_.persistence = 0;
-  options_.seed = noise::module::DEFAULT_RIDGED_SEED;
+NoiseOptions RidgedMultiNoise::getDefaultOptions() {
+  NoiseOptions options;
+  options.frequency = noise::module::DEFAULT_RIDGED_FREQUENCY;
+  options.lacunarity = noise::module::DEFAULT_RIDGED_LACUNARITY;
+  options.octaveCount = noise::module::DEFAULT_RIDGED_OCTAVE_COUNT;
+  options.persistence = 0;
+  options.seed = noise::module::DEFAULT_RIDGED_SEED;
+  return options;
 }
 
-GLfloat RidgedMultiNoise::getValue(const float &x, const float &y,
-                                   const float &z) {
+std::shared_ptr<const NoiseInterface>
+RidgedMultiNoise::withOptions(const NoiseOptions &options) const {
+  return std::shared_ptr<const NoiseInterface>(new RidgedMultiNoise(options));
+}
+
+int RidgedMultiNoise::getAlgorithm() const {
+  return Defaults::RidgedMulti;
+}
+
+float RidgedMultiNoise::getValue(const float &x, const float &y,
+                                 const float &z) const {
+  // terrain lies in the plane y = 0, where the cheaper 2D kernel applies
+  if (y == 0.0f) {
+    return NoiseKernel::ridgedMulti(octaves_, applyResolution(x),
+                                    applyResolution(z));
+  }
   return noise_->GetValue(applyResolution(x), y, applyResolution(z));
 }
 
-void RidgedMultiNoise::setOptions(const NoiseOptions &options) {
-  options_ = options;
-  noise_->SetFrequency(options_.frequency);
-  noise_->SetLacunarity(options_.lacunarity);
-  noise_->SetOctaveCount(options_.octaveCount);
-  noise_->SetSeed(options_.seed);
+void RidgedMultiNoise::fillHeights(const int &xOffset, const int &zOffset,
+                                   const int &columns, const int &rows,
+                                   const int &stride, float *out) const {
+  std::vector<double> x = sampleCoordinates(xOffset, columns);
+  std::vector<double> z = sampleCoordinates(zOffset, rows);
+  for (int row = 0; row < rows; row++) {
+    NoiseKernel::ridgedMulti(octaves_, &x.front(), z[row], columns,
+                             out + row * stride);
+  }
 }
 
 // Billow
 
-BillowNoise::BillowNoise() {
-  noise_ = std::shared_ptr<noise::module::Billow>(new noise::module::Billow);
-  initializeOptions();
+BillowNoise::BillowNoise(const NoiseOptions &options)
+    : NoiseInterface(options) {
+  // module is configured once and only read afterwards
+  noise::module::Billow *module = new noise::module::Billow;
+  module->SetFrequency(options_.frequency);
+  module->SetLacunarity(options_.lacunarity);
+  module->SetOctaveCount(options_.octaveCount);
+  module->SetPersistence(options_.persistence);
+  module->SetSeed(options_.seed);
+  noise_ = std::shared_ptr<const noise::module::Billow>(module);
+  octaves_ = NoiseKernel::octavesOf(*noise_);
+}
+
+NoiseOptions BillowNoise::getDefaultOptions() {
+  NoiseOptions options;
+  options.frequency = noise::module::DEFAULT_BILLOW_FREQUENCY;
+  options.lacunarity = noise::module::DEFAULT_BILLOW_LACUNARITY;
+  options.octaveCount = noise::module::DEFAULT_BILLOW_OCTAVE_COUNT;
+  options.persistence = noise::module::DEFAULT_BILLOW_PERSISTENCE;
+  options.seed = noise::module::DEFAULT_BILLOW_SEED;
+  return options;
+}
+
+std::shared_ptr<const NoiseInterface>
+BillowNoise::withOptions(const NoiseOptions &options) const {
+  return std::shared_ptr<const NoiseInterface>(new BillowNoise(options));
+}
+
+int BillowNoise::getAlgorithm() const {
+  return Defaults::Billow;
 }
 
-GLfloat BillowNoise::getValue(const float &x, const float &y, const float &z) {
+float BillowNoise::getValue(const float &x, const float &y,
+                            const float &z) const {
+  // terrain lies in the plane y = 0, where the cheaper 2D kernel applies
+  if (y == 0.0f) {
+    return NoiseKernel::billow(octaves_, applyResolution(x),
+                               applyResolution(z));
+  }
   return noise_->GetValue(applyResolution(x), y, applyResolution(z));
 }
 
-void BillowNoise::initializeOptions() {
-  options_.frequency = noise::module::DEFAULT_BILLOW_FREQUENCY;
-  options_.lacunarity = noise::module::DEFAULT_BILLOW_LACUNARITY;
-  options_.octaveCount = noise::module::DEFAULT_BILLOW_OCTAVE_COUNT;
-  options_.persistence = noise::module::DEFAULT_BILLOW_PERSISTENCE;
-  options_.seed = noise::module::DEFAULT_BILLOW_SEED;
+void BillowNoise::fillHeights(const int &xOffset, const int &zOffset,
+                              const int &columns, const int &rows,
+                              const int &stride, float *out) const {
+  std::vector<double> x = sampleCoordinates(xOffset, columns);
+  std::vector<double> z = sampleCoordinates(zOffset, rows);
+  for (int row = 0; row < rows; row++) {
+    NoiseKernel::billow(octaves_, &x.front(), z[row], columns,
+                        out + row * stride);
+  }
 }
 
-void BillowNoise::setOptions(const NoiseOptions &options) {
-  options_ = options;
-  noise_->SetFrequency(options_.frequency);
-  noise_->SetLacunarity(options_.lacunarity);
-  noise_->SetOctaveCount(options_.octaveCount);
-  noise_->SetPersistence(options_.persistence);
-  noise_->SetSeed(options_.seed);
-};
+bool BillowNoise::hasLayers() const {
+  return true;
+}
+
+void BillowNoise::fillLayers(const int &xOffset, const int &zOffset,
+                             const int &width, const int &firstOctave,
+                             double *layers) const {
+  std::vector<double> x = sampleCoordinates(xOffset, width);
+  std::vector<double> z = sampleCoordinates(zOffset, width);
+  for (int row = 0; row < width; row++) {
+    NoiseKernel::billowLayers(octaves_, firstOctave, &x.front(), z[row],
+                              width, width * width, layers + row * width);
+  }
+}
+
+void BillowNoise::combineLayers(const double *layers, const int &count,
+                                float *out) const {
+  NoiseKernel::combineLayers(octaves_.persistence, octaves_.octaveCount, 0.5,
+                             layers, count, out);
+}
 
 // Random
 
-float RandomNoise::getValue(const float &x, const float &y, const float &z) {
+RandomNoise::RandomNoise(const NoiseOptions &options)
+    : NoiseInterface(options) {
+}
+
+NoiseOptions RandomNoise::getDefaultOptions() {
+  // random noise only uses the seed
+  NoiseOptions options = {};
+  options.seed = noise::module::DEFAULT_PERLIN_SEED;
+  return options;
+}
+
+std::shared_ptr<const NoiseInterface>
+RandomNoise::withOptions(const NoiseOptions &options) const {
+  return std::shared_ptr<const NoiseInterface>(new RandomNoise(options));
+}
+
+int RandomNoise::getAlgorithm() const {
+  return Defaults::Random;
+}
+
+float RandomNoise::getValue(const float &x, const float &y,
+                            const float &z) const {
   // return random float between 0 and 1
-  return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+  return NoiseKernel::random(options_.seed, static_cast<int>(std::floor(x)),
+                             static_cast<int>(std::floor(z)));
+}
+
+void RandomNoise::fillHeights(const int &xOffset, const int &zOffset,
+                              const int &columns, const int &rows,
+                              const int &stride, float *out) const {
+  for (int row = 0; row < rows; row++) {
+    NoiseKernel::random(options_.seed, xOffset, zOffset + row, columns,
+                        out + row * stride);
+  }
+}
+
+// Mountains
+
+MountainNoise::MountainNoise(const NoiseOptions &options)
+    : NoiseInterface(options) {
+  // graph is compiled once and only read afterwards
+  NoiseGraph *graph = new NoiseGraph;
+
+  noise::module::RidgedMulti mountains;
+  mountains.SetFrequency(options_.frequency);
+  mountains.SetLacunarity(options_.lacunarity);
+  mountains.SetOctaveCount(options_.octaveCount);
+  mountains.SetSeed(options_.seed);
+
+  // low, flat plains
+  noise::module::Billow plains;
+  plains.SetFrequency(2.0 * options_.frequency);
+  plains.SetLacunarity(options_.lacunarity);
+  plains.SetOctaveCount(options_.octaveCount);
+  plains.SetPersistence(options_.persistence);
+  plains.SetSeed(options_.seed);
+
+  // large areas of mountains or plains
+  noise::module::Perlin terrainType;
+  terrainType.SetFrequency(0.5 * options_.frequency);
+  terrainType.SetLacunarity(options_.lacunarity);
+  terrainType.SetOctaveCount(options_.octaveCount);
+  terrainType.SetPersistence(0.25);
+  terrainType.SetSeed(options_.seed + 1);
+
+  NoiseGraph::Node terrain = graph->select(
+      graph->scaleBias(graph->billow(plains), 0.125, -0.75),
+      graph->ridgedMulti(mountains), graph->perlin(terrainType), 0.0, 1000.0,
+      0.125);
+  graph->compile(graph->turbulence(terrain, 4.0 * options_.frequency, 0.125,
+                                   3, options_.seed));
+  graph_ = std::shared_ptr<const NoiseGraph>(graph);
+}
+
+NoiseOptions MountainNoise::getDefaultOptions() {
+  NoiseOptions options;
+  options.frequency = noise::module::DEFAULT_RIDGED_FREQUENCY;
+  options.lacunarity = noise::module::DEFAULT_RIDGED_LACUNARITY;
+  options.octaveCount = noise::module::DEFAULT_RIDGED_OCTAVE_COUNT;
+  // only used by plains
+  options.persistence = noise::module::DEFAULT_BILLOW_PERSISTENCE;
+  options.seed = noise::module::DEFAULT_RIDGED_SEED;
+  return options;
+}
+
+std::shared_ptr<const NoiseInterface>
+MountainNoise::withOptions(const NoiseOptions &options) const {
+  return std::shared_ptr<const NoiseInterface>(new MountainNoise(options));
+}
+
+int MountainNoise::getAlgorithm() const {
+  return Defaults::Mountains;
+}
+
+float MountainNoise::getValue(const float &x, const float &y,
+                              const float &z) const {
+  return static_cast<float>(
+      graph_->getValue(applyResolution(x), applyResolution(z)));
+}
+
+void MountainNoise::fillHeights(const int &xOffset, const int &zOffset,
+                                const int &columns, const int &rows,
+                                const int &stride, float *out) const {
+  // whole grid in one call, so the graph works on full blocks
+  std::vector<double> columnX = sampleCoordinates(xOffset, columns);
+  std::vector<double> rowZ = sampleCoordinates(zOffset, rows);
+  std::vector<double> x(columns * rows), z(columns * rows);
+  for (int row = 0; row < rows; row++) {
+    std::copy(columnX.begin(), columnX.end(), x.begin() + row * columns);
+    std::fill(z.begin() + row * columns, z.begin() + (row + 1) * columns,
+              rowZ[row]);
+  }
+
+  std::vector<double> values(columns * rows);
+  graph_->evaluate(&x.front(), &z.front(), columns * rows, &values.front());
+  for (int row = 0; row < rows; row++) {
+    for (int column = 0; column < columns; column++) {
+      out[row * stride + column] =
+          static_cast<float>(values[row * columns + column]);
+    }
+  }
 }
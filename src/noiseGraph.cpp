@@ -0,0 +1,397 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "noiseGraph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <noise/interp.h>
+
+namespace {
+
+// samples evaluated together, so all registers stay in cache
+const int BlockSize = 256;
+
+// offsets of the distortion noise of noise::module::Turbulence, so it is not
+// zero at integer coordinates
+const double XDistortX = 12414.0 / 65536.0;
+const double XDistortZ = 31337.0 / 65536.0;
+const double ZDistortX = 53820.0 / 65536.0;
+const double ZDistortZ = 44845.0 / 65536.0;
+
+} // namespace
+
+NoiseGraph::NoiseGraph() : registerCount_(0), spaceCount_(0), output_(-1) {
+}
+
+NoiseGraph::Node NoiseGraph::perlin(const noise::module::Perlin &module) {
+  Node node = addNode(Perlin, 0);
+  nodes_[node].octaves[0] = NoiseKernel::octavesOf(module);
+  return node;
+}
+
+NoiseGraph::Node NoiseGraph::billow(const noise::module::Billow &module) {
+  Node node = addNode(Billow, 0);
+  nodes_[node].octaves[0] = NoiseKernel::octavesOf(module);
+  return node;
+}
+
+NoiseGraph::Node
+NoiseGraph::ridgedMulti(const noise::module::RidgedMulti &module) {
+  Node node = addNode(RidgedMulti, 0);
+  nodes_[node].octaves[0] = NoiseKernel::octavesOf(module);
+  return node;
+}
+
+NoiseGraph::Node NoiseGraph::constant(const double &value) {
+  Node node = addNode(Constant, 0);
+  nodes_[node].parameters[0] = value;
+  return node;
+}
+
+NoiseGraph::Node NoiseGraph::scaleBias(const Node &source, const double &scale,
+                                       const double &bias) {
+  Node node = addNode(ScaleBias, 1, source);
+  nodes_[node].parameters[0] = scale;
+  nodes_[node].parameters[1] = bias;
+  return node;
+}
+
+NoiseGraph::Node NoiseGraph::abs(const Node &source) {
+  return addNode(Abs, 1, source);
+}
+
+NoiseGraph::Node NoiseGraph::clamp(const Node &source, const double &lower,
+                                   const double &upper) {
+  Node node = addNode(Clamp, 1, source);
+  nodes_[node].parameters[0] = lower;
+  nodes_[node].parameters[1] = upper;
+  return node;
+}
+
+NoiseGraph::Node NoiseGraph::exponent(const Node &source,
+                                      const double &exponent) {
+  Node node = addNode(Exponent, 1, source);
+  nodes_[node].parameters[0] = exponent;
+  return node;
+}
+
+NoiseGraph::Node NoiseGraph::invert(const Node &source) {
+  return addNode(Invert, 1, source);
+}
+
+NoiseGraph::Node NoiseGraph::add(const Node &source0, const Node &source1) {
+  return addNode(Add, 2, source0, source1);
+}
+
+NoiseGraph::Node NoiseGraph::multiply(const Node &source0,
+                                      const Node &source1) {
+  return addNode(Multiply, 2, source0, source1);
+}
+
+NoiseGraph::Node NoiseGraph::min(const Node &source0, const Node &source1) {
+  return addNode(Min, 2, source0, source1);
+}
+
+NoiseGraph::Node NoiseGraph::max(const Node &source0, const Node &source1) {
+  return addNode(Max, 2, source0, source1);
+}
+
+NoiseGraph::Node NoiseGraph::blend(const Node &source0, const Node &source1,
+                                   const Node &control) {
+  return addNode(Blend, 3, source0, source1, control);
+}
+
+NoiseGraph::Node NoiseGraph::select(const Node &source0, const Node &source1,
+                                    const Node &control, const double &lower,
+                                    const double &upper,
+                                    const double &edgeFalloff) {
+  Node node = addNode(Select, 3, source0, source1, control);
+  nodes_[node].parameters[0] = lower;
+  nodes_[node].parameters[1] = upper;
+  // falloff curves must not overlap, as in noise::module::Select
+  nodes_[node].parameters[2] = std::min(edgeFalloff, (upper - lower) / 2);
+  return node;
+}
+
+NoiseGraph::Node NoiseGraph::turbulence(const Node &source,
+                                        const double &frequency,
+                                        const double &power,
+                                        const int &roughness,
+                                        const int &seed) {
+  Node node = addNode(Turbulence, 1, source);
+  nodes_[node].parameters[0] = power;
+  // distortion modules of noise::module::Turbulence, the y module is unused
+  noise::module::Perlin distort;
+  distort.SetFrequency(frequency);
+  distort.SetOctaveCount(roughness);
+  distort.SetSeed(seed);
+  nodes_[node].octaves[0] = NoiseKernel::octavesOf(distort);
+  distort.SetSeed(seed + 2);
+  nodes_[node].octaves[1] = NoiseKernel::octavesOf(distort);
+  return node;
+}
+
+void NoiseGraph::compile(const Node &output) {
+  program_.clear();
+  registerCount_ = 0;
+  spaceCount_ = 1;
+  output_ = -1;
+  if (output < 0 || output >= getNodeCount()) {
+    std::cerr << "Error: unknown noise graph node " << output << std::endl;
+    return;
+  }
+
+  // register of each node at each space, -1 if not compiled yet
+  std::vector<std::vector<int>> compiled(1,
+                                         std::vector<int>(nodes_.size(), -1));
+  output_ = compileNode(output, 0, compiled);
+}
+
+void NoiseGraph::evaluate(const double *x, const double *z, const int &count,
+                          double *out) const {
+  if (output_ < 0) {
+    std::cerr << "Error: noise graph is not compiled" << std::endl;
+    std::fill(out, out + count, 0.0);
+    return;
+  }
+
+  // x and z of each space, then values of each register, for one block.
+  // Buffers of few samples are only as large as needed
+  int blockSize = std::max(std::min(BlockSize, count), 1);
+  std::vector<double> spaces(2 * spaceCount_ * blockSize);
+  std::vector<double> registers(registerCount_ * blockSize);
+  std::vector<double> scratch(2 * blockSize);
+
+  for (int start = 0; start < count; start += blockSize) {
+    int size = std::min(blockSize, count - start);
+    std::copy(x + start, x + start + size, spaces.begin());
+    std::copy(z + start, z + start + size, spaces.begin() + blockSize);
+
+    for (const Instruction &instruction : program_) {
+      execute(instruction, size, blockSize, &registers.front(),
+              &spaces.front(), &scratch.front());
+    }
+
+    const double *value = &registers[output_ * blockSize];
+    std::copy(value, value + size, out + start);
+  }
+}
+
+double NoiseGraph::getValue(const double &x, const double &z) const {
+  double value;
+  evaluate(&x, &z, 1, &value);
+  return value;
+}
+
+int NoiseGraph::getNodeCount() const {
+  return nodes_.size();
+}
+
+int NoiseGraph::getInstructionCount() const {
+  return program_.size();
+}
+
+NoiseGraph::Node NoiseGraph::addNode(const Operation &operation,
+                                     const int &inputCount, Node input0,
+                                     Node input1, Node input2) {
+  Node *inputs[] = {&input0, &input1, &input2};
+  for (int i = 0; i < inputCount; i++) {
+    // unknown inputs evaluate to 0
+    if (*inputs[i] < 0 || *inputs[i] >= getNodeCount()) {
+      std::cerr << "Error: unknown noise graph node " << *inputs[i]
+                << std::endl;
+      *inputs[i] = constant(0.0);
+    }
+  }
+
+  Module module = {};
+  module.operation = operation;
+  module.inputCount = inputCount;
+  for (int i = 0; i < inputCount; i++) {
+    module.inputs[i] = *inputs[i];
+  }
+  nodes_.push_back(module);
+  return nodes_.size() - 1;
+}
+
+int NoiseGraph::compileNode(const Node &node, const int &space,
+                            std::vector<std::vector<int>> &compiled) {
+  if (compiled[space][node] >= 0) {
+    return compiled[space][node];
+  }
+
+  const Module &module = nodes_[node];
+  Instruction instruction = {};
+  instruction.operation = module.operation;
+  instruction.node = node;
+  instruction.space = space;
+
+  int target;
+  if (module.operation == Turbulence) {
+    // displace coordinates, then evaluate source at them
+    instruction.target = spaceCount_++;
+    compiled.push_back(std::vector<int>(nodes_.size(), -1));
+    program_.push_back(instruction);
+    target = compileNode(module.inputs[0], instruction.target, compiled);
+  } else {
+    for (int i = 0; i < module.inputCount; i++) {
+      instruction.inputs[i] = compileNode(module.inputs[i], space, compiled);
+    }
+    instruction.target = target = registerCount_++;
+    program_.push_back(instruction);
+  }
+
+  compiled[space][node] = target;
+  return target;
+}
+
+void NoiseGraph::execute(const Instruction &instruction, const int &count,
+                         const int &blockSize, double *registers,
+                         double *spaces, double *scratch) const {
+  const Module &module = nodes_[instruction.node];
+  const double *x = spaces + 2 * instruction.space * blockSize;
+  const double *z = x + blockSize;
+  const double *a = registers + instruction.inputs[0] * blockSize;
+  const double *b = registers + instruction.inputs[1] * blockSize;
+  const double *c = registers + instruction.inputs[2] * blockSize;
+  double *out = registers + instruction.target * blockSize;
+  const double *parameters = module.parameters;
+
+  switch (instruction.operation) {
+  case Perlin:
+    NoiseKernel::perlin(module.octaves[0], x, z, count, out);
+    break;
+  case Billow:
+    NoiseKernel::billow(module.octaves[0], x, z, count, out);
+    break;
+  case RidgedMulti:
+    NoiseKernel::ridgedMulti(module.octaves[0], x, z, count, out);
+    break;
+  case Constant:
+    std::fill(out, out + count, parameters[0]);
+    break;
+  case ScaleBias:
+    for (int i = 0; i < count; i++) {
+      out[i] = a[i] * parameters[0] + parameters[1];
+    }
+    break;
+  case Abs:
+    for (int i = 0; i < count; i++) {
+      out[i] = std::fabs(a[i]);
+    }
+    break;
+  case Clamp:
+    for (int i = 0; i < count; i++) {
+      out[i] = a[i] < parameters[0]
+                   ? parameters[0]
+                   : (a[i] > parameters[1] ? parameters[1] : a[i]);
+    }
+    break;
+  case Exponent:
+    for (int i = 0; i < count; i++) {
+      out[i] =
+          std::pow(std::fabs((a[i] + 1.0) / 2.0), parameters[0]) * 2.0 - 1.0;
+    }
+    break;
+  case Invert:
+    for (int i = 0; i < count; i++) {
+      out[i] = -a[i];
+    }
+    break;
+  case Add:
+    for (int i = 0; i < count; i++) {
+      out[i] = a[i] + b[i];
+    }
+    break;
+  case Multiply:
+    for (int i = 0; i < count; i++) {
+      out[i] = a[i] * b[i];
+    }
+    break;
+  case Min:
+    for (int i = 0; i < count; i++) {
+      out[i] = noise::GetMin(a[i], b[i]);
+    }
+    break;
+  case Max:
+    for (int i = 0; i < count; i++) {
+      out[i] = noise::GetMax(a[i], b[i]);
+    }
+    break;
+  case Blend:
+    for (int i = 0; i < count; i++) {
+      out[i] = noise::LinearInterp(a[i], b[i], (c[i] + 1.0) / 2.0);
+    }
+    break;
+  case Select: {
+    // same cases as noise::module::Select::GetValue()
+    double lower = parameters[0];
+    double upper = parameters[1];
+    double falloff = parameters[2];
+    for (int i = 0; i < count; i++) {
+      double control = c[i];
+      if (falloff <= 0.0) {
+        out[i] = control < lower || control > upper ? a[i] : b[i];
+      } else if (control < lower - falloff) {
+        out[i] = a[i];
+      } else if (control < lower + falloff) {
+        double alpha = noise::SCurve3((control - (lower - falloff)) /
+                                      ((lower + falloff) - (lower - falloff)));
+        out[i] = noise::LinearInterp(a[i], b[i], alpha);
+      } else if (control < upper - falloff) {
+        out[i] = b[i];
+      } else if (control < upper + falloff) {
+        double alpha = noise::SCurve3((control - (upper - falloff)) /
+                                      ((upper + falloff) - (upper - falloff)));
+        out[i] = noise::LinearInterp(b[i], a[i], alpha);
+      } else {
+        out[i] = a[i];
+      }
+    }
+    break;
+  }
+  case Turbulence: {
+    double *displacedX = spaces + 2 * instruction.target * blockSize;
+    double *displacedZ = displacedX + blockSize;
+    double *distortX = scratch;
+    double *distortZ = scratch + blockSize;
+    double power = parameters[0];
+
+    for (int i = 0; i < count; i++) {
+      displacedX[i] = x[i] + XDistortX;
+      displacedZ[i] = z[i] + XDistortZ;
+    }
+    NoiseKernel::perlin(module.octaves[0], displacedX, displacedZ, count,
+                        distortX);
+    for (int i = 0; i < count; i++) {
+      displacedX[i] = x[i] + ZDistortX;
+      displacedZ[i] = z[i] + ZDistortZ;
+    }
+    NoiseKernel::perlin(module.octaves[1], displacedX, displacedZ, count,
+                        distortZ);
+    for (int i = 0; i < count; i++) {
+      displacedX[i] = x[i] + distortX[i] * power;
+      displacedZ[i] = z[i] + distortZ[i] * power;
+    }
+    break;
+  }
+  }
+}
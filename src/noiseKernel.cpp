@@ -0,0 +1,472 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "noiseKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <noise/interp.h>
+
+namespace noise {
+// gradient table of libnoise, defined in noisegen.cpp. Using the very same
+// table keeps results identical to the scalar modules
+extern double g_randomVectors[256 * 4];
+}
+
+namespace NoiseKernel {
+
+namespace {
+
+// constants of noise::GradientNoise3D(). Y is not needed, lattice points of
+// the plane y = 0 have iy = 0
+const unsigned int XNoiseGen = 1619;
+const unsigned int ZNoiseGen = 6971;
+const unsigned int SeedNoiseGen = 1013;
+const unsigned int ShiftNoiseGen = 8;
+
+// index into gradient table of lattice point ix, 0, iz, as in
+// noise::GradientNoise3D(). Hash is computed unsigned to avoid signed
+// overflow, only its lowest 16 bits are used anyway
+inline int gradientIndex(const int &ix, const int &iz, const int &seed) {
+  unsigned int hash = XNoiseGen * ix + ZNoiseGen * iz + SeedNoiseGen * seed;
+  return static_cast<int>((hash ^ (hash >> ShiftNoiseGen)) & 0xff) << 2;
+}
+
+// map interpolants of all N samples onto s-curve of quality
+template <int N>
+void applyQuality(const noise::NoiseQuality &quality, double *s) {
+  switch (quality) {
+  case noise::QUALITY_FAST:
+    break;
+  case noise::QUALITY_STD:
+    for (int i = 0; i < N; i++) {
+      s[i] = noise::SCurve3(s[i]);
+    }
+    break;
+  case noise::QUALITY_BEST:
+    for (int i = 0; i < N; i++) {
+      s[i] = noise::SCurve5(s[i]);
+    }
+    break;
+  }
+}
+
+// same as noise::GradientNoise3D() for lattice points x0 + dx, 0, z0 + dz of
+// all N samples. The y component of the distance is 0, so the y component of
+// the gradient drops out. Only the table lookups are done sample by sample,
+// hashing and dot products are left to the vectorizer
+template <int N>
+void gradientNoise(const double *x, const double *z, const int *x0,
+                   const int *z0, const int &dx, const int &dz,
+                   const int &seed, double *out) {
+  int index[N];
+  for (int i = 0; i < N; i++) {
+    index[i] = gradientIndex(x0[i] + dx, z0[i] + dz, seed);
+  }
+
+  double gx[N], gz[N];
+  for (int i = 0; i < N; i++) {
+    gx[i] = noise::g_randomVectors[index[i]];
+    gz[i] = noise::g_randomVectors[index[i] + 2];
+  }
+
+  for (int i = 0; i < N; i++) {
+    out[i] = ((gx[i] * (x[i] - static_cast<double>(x0[i] + dx))) +
+              (gz[i] * (z[i] - static_cast<double>(z0[i] + dz)))) *
+             2.12;
+  }
+}
+
+// same as noise::GradientCoherentNoise3D() at y = 0 for all N samples. There
+// y lies on the upper face of the lattice cube (y0 = -1, y1 = 0) and the
+// interpolant along y is exactly 1, so only the four corners at y1 contribute
+// and the result is bilinear in x and z
+template <int N>
+void coherentNoise(const double *x, const double *z, const int &seed,
+                   const noise::NoiseQuality &quality, double *out) {
+  int x0[N], z0[N];
+  double xs[N], zs[N];
+
+  for (int i = 0; i < N; i++) {
+    x0[i] = x[i] > 0.0 ? static_cast<int>(x[i]) : static_cast<int>(x[i]) - 1;
+    z0[i] = z[i] > 0.0 ? static_cast<int>(z[i]) : static_cast<int>(z[i]) - 1;
+    xs[i] = x[i] - static_cast<double>(x0[i]);
+    zs[i] = z[i] - static_cast<double>(z0[i]);
+  }
+  applyQuality<N>(quality, xs);
+  applyQuality<N>(quality, zs);
+
+  double ix[2][N];
+  for (int dz = 0; dz < 2; dz++) {
+    double n0[N], n1[N];
+    gradientNoise<N>(x, z, x0, z0, 0, dz, seed, n0);
+    gradientNoise<N>(x, z, x0, z0, 1, dz, seed, n1);
+    for (int i = 0; i < N; i++) {
+      ix[dz][i] = noise::LinearInterp(n0[i], n1[i], xs[i]);
+    }
+  }
+
+  for (int i = 0; i < N; i++) {
+    out[i] = noise::LinearInterp(ix[0][i], ix[1][i], zs[i]);
+  }
+}
+
+// same as noise::MakeInt32Range() for all N samples
+template <int N> void makeInt32Range(const double *in, double *out) {
+  for (int i = 0; i < N; i++) {
+    out[i] = noise::MakeInt32Range(in[i]);
+  }
+}
+
+template <int N>
+void nextOctave(const double &lacunarity, double *px, double *pz) {
+  for (int i = 0; i < N; i++) {
+    px[i] *= lacunarity;
+    pz[i] *= lacunarity;
+  }
+}
+
+// octave loops of the modules for N samples at px, pz, already scaled by
+// frequency. px and pz are used as scratch space
+
+template <int N>
+void perlinBlock(const Octaves &octaves, double *px, double *pz,
+                 double *value) {
+  double nx[N], nz[N], signal[N];
+  double curPersistence = 1.0;
+  std::fill(value, value + N, 0.0);
+
+  for (int octave = 0; octave < octaves.octaveCount; octave++) {
+    makeInt32Range<N>(px, nx);
+    makeInt32Range<N>(pz, nz);
+    int seed = (octaves.seed + octave) & 0xffffffff;
+    coherentNoise<N>(nx, nz, seed, octaves.quality, signal);
+    for (int i = 0; i < N; i++) {
+      value[i] += signal[i] * curPersistence;
+    }
+    nextOctave<N>(octaves.lacunarity, px, pz);
+    curPersistence *= octaves.persistence;
+  }
+}
+
+template <int N>
+void billowBlock(const Octaves &octaves, double *px, double *pz,
+                 double *value) {
+  double nx[N], nz[N], signal[N];
+  double curPersistence = 1.0;
+  std::fill(value, value + N, 0.0);
+
+  for (int octave = 0; octave < octaves.octaveCount; octave++) {
+    makeInt32Range<N>(px, nx);
+    makeInt32Range<N>(pz, nz);
+    int seed = (octaves.seed + octave) & 0xffffffff;
+    coherentNoise<N>(nx, nz, seed, octaves.quality, signal);
+    for (int i = 0; i < N; i++) {
+      value[i] += (2.0 * std::fabs(signal[i]) - 1.0) * curPersistence;
+    }
+    nextOctave<N>(octaves.lacunarity, px, pz);
+    curPersistence *= octaves.persistence;
+  }
+  for (int i = 0; i < N; i++) {
+    value[i] += 0.5;
+  }
+}
+
+template <int N>
+void ridgedMultiBlock(const Octaves &octaves, double *px, double *pz,
+                      double *value) {
+  const double offset = 1.0;
+  const double gain = 2.0;
+  double nx[N], nz[N], signal[N], weight[N];
+  std::fill(value, value + N, 0.0);
+  std::fill(weight, weight + N, 1.0);
+
+  for (int octave = 0; octave < octaves.octaveCount; octave++) {
+    makeInt32Range<N>(px, nx);
+    makeInt32Range<N>(pz, nz);
+    int seed = (octaves.seed + octave) & 0x7fffffff;
+    coherentNoise<N>(nx, nz, seed, octaves.quality, signal);
+    for (int i = 0; i < N; i++) {
+      // sharp ridges, weighted by signal of previous octave
+      double ridge = offset - std::fabs(signal[i]);
+      ridge *= ridge;
+      ridge *= weight[i];
+      weight[i] = std::min(std::max(ridge * gain, 0.0), 1.0);
+      value[i] += ridge * octaves.spectralWeights[octave];
+    }
+    nextOctave<N>(octaves.lacunarity, px, pz);
+  }
+  for (int i = 0; i < N; i++) {
+    value[i] = (value[i] * 1.25) - 1.0;
+  }
+}
+
+// signal of octaves firstOctave up to octaveCount for N samples, octave o of
+// sample i written to layers[o][i]. Same signal as perlinBlock(), or as
+// billowBlock() if Billow is set
+template <int N, bool Billow>
+void layerBlock(const Octaves &octaves, const int &firstOctave, double *px,
+                double *pz, double (*layers)[N]) {
+  double nx[N], nz[N], signal[N];
+
+  for (int octave = 0; octave < octaves.octaveCount; octave++) {
+    // positions of skipped octaves are still scaled one by one, exactly as
+    // in the octave loops
+    if (octave >= firstOctave) {
+      makeInt32Range<N>(px, nx);
+      makeInt32Range<N>(pz, nz);
+      int seed = (octaves.seed + octave) & 0xffffffff;
+      coherentNoise<N>(nx, nz, seed, octaves.quality, signal);
+      for (int i = 0; i < N; i++) {
+        layers[octave][i] = Billow ? 2.0 * std::fabs(signal[i]) - 1.0
+                                   : signal[i];
+      }
+    }
+    nextOctave<N>(octaves.lacunarity, px, pz);
+  }
+}
+
+// evaluate layers of row in blocks of Lanes samples
+template <bool Billow>
+void evaluateLayers(const Octaves &octaves, const int &firstOctave,
+                    const double *x, const double &z, const int &count,
+                    const int &stride, double *layers) {
+  double block[noise::module::PERLIN_MAX_OCTAVE][Lanes];
+  int octaveCount =
+      std::min(octaves.octaveCount, noise::module::PERLIN_MAX_OCTAVE);
+
+  for (int start = 0; start < count; start += Lanes) {
+    double px[Lanes], pz[Lanes];
+    for (int i = 0; i < Lanes; i++) {
+      px[i] = x[std::min(start + i, count - 1)] * octaves.frequency;
+      pz[i] = z * octaves.frequency;
+    }
+    layerBlock<Lanes, Billow>(octaves, firstOctave, px, pz, block);
+
+    int end = std::min(Lanes, count - start);
+    for (int octave = firstOctave; octave < octaveCount; octave++) {
+      for (int i = 0; i < end; i++) {
+        layers[octave * stride + start + i] = block[octave][i];
+      }
+    }
+  }
+}
+
+typedef void (*Block)(const Octaves &, double *, double *, double *);
+
+// evaluate row in blocks of Lanes samples. Lanes past count repeat the last
+// sample
+template <Block block>
+void evaluateRow(const Octaves &octaves, const double *x, const double &z,
+                 const int &count, float *out) {
+  for (int start = 0; start < count; start += Lanes) {
+    double px[Lanes], pz[Lanes], value[Lanes];
+    for (int i = 0; i < Lanes; i++) {
+      px[i] = x[std::min(start + i, count - 1)] * octaves.frequency;
+      pz[i] = z * octaves.frequency;
+    }
+    block(octaves, px, pz, value);
+
+    int end = std::min(Lanes, count - start);
+    for (int i = 0; i < end; i++) {
+      out[start + i] = static_cast<float>(value[i]);
+    }
+  }
+}
+
+// evaluate samples at x[i], z[i] in blocks of Lanes samples
+template <Block block>
+void evaluatePoints(const Octaves &octaves, const double *x, const double *z,
+                    const int &count, double *out) {
+  for (int start = 0; start < count; start += Lanes) {
+    double px[Lanes], pz[Lanes], value[Lanes];
+    for (int i = 0; i < Lanes; i++) {
+      int sample = std::min(start + i, count - 1);
+      px[i] = x[sample] * octaves.frequency;
+      pz[i] = z[sample] * octaves.frequency;
+    }
+    block(octaves, px, pz, value);
+
+    int end = std::min(Lanes, count - start);
+    std::copy(value, value + end, out + start);
+  }
+}
+
+template <Block block>
+float evaluate(const Octaves &octaves, const double &x, const double &z) {
+  double px = x * octaves.frequency;
+  double pz = z * octaves.frequency;
+  double value;
+  block(octaves, &px, &pz, &value);
+  return static_cast<float>(value);
+}
+
+Octaves octavesOf(const double &frequency, const double &lacunarity,
+                  const double &persistence, const int &octaveCount,
+                  const int &seed, const noise::NoiseQuality &quality) {
+  Octaves octaves;
+  octaves.frequency = frequency;
+  octaves.lacunarity = lacunarity;
+  octaves.persistence = persistence;
+  octaves.octaveCount = octaveCount;
+  octaves.seed = seed;
+  octaves.quality = quality;
+  std::fill(octaves.spectralWeights,
+            octaves.spectralWeights + noise::module::RIDGED_MAX_OCTAVE, 0.0);
+  return octaves;
+}
+
+// largest value of the 24 bits of a hash used for white noise. Exactly
+// representable as float, so all values map evenly onto [0, 1]
+const float RandomMaximum = 16777215.0f;
+
+// integer hash of seed and coordinates x, z. Inputs are spread with odd
+// constants and mixed with the lowbias32 finalizer of Chris Wellons. Only
+// multiplications, shifts and xors, so loops over it vectorize
+inline unsigned int randomHash(const int &seed, const int &x, const int &z) {
+  unsigned int hash = (static_cast<unsigned int>(x) * 0x9e3779b1u) ^
+                      (static_cast<unsigned int>(z) * 0x85ebca77u) ^
+                      (static_cast<unsigned int>(seed) * 0xc2b2ae3du);
+  hash ^= hash >> 16;
+  hash *= 0x7feb352du;
+  hash ^= hash >> 15;
+  hash *= 0x846ca68bu;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+} // namespace
+
+Octaves octavesOf(const noise::module::Perlin &module) {
+  return octavesOf(module.GetFrequency(), module.GetLacunarity(),
+                   module.GetPersistence(), module.GetOctaveCount(),
+                   module.GetSeed(), module.GetNoiseQuality());
+}
+
+Octaves octavesOf(const noise::module::Billow &module) {
+  return octavesOf(module.GetFrequency(), module.GetLacunarity(),
+                   module.GetPersistence(), module.GetOctaveCount(),
+                   module.GetSeed(), module.GetNoiseQuality());
+}
+
+Octaves octavesOf(const noise::module::RidgedMulti &module) {
+  // ridged multifractal noise has no persistence
+  Octaves octaves =
+      octavesOf(module.GetFrequency(), module.GetLacunarity(), 0.0,
+                module.GetOctaveCount(), module.GetSeed(),
+                module.GetNoiseQuality());
+
+  // same as noise::module::RidgedMulti::CalcSpectralWeights() with h = 1
+  double frequency = 1.0;
+  for (int i = 0; i < noise::module::RIDGED_MAX_OCTAVE; i++) {
+    octaves.spectralWeights[i] = std::pow(frequency, -1.0);
+    frequency *= octaves.lacunarity;
+  }
+  return octaves;
+}
+
+void perlin(const Octaves &octaves, const double *x, const double &z,
+            const int &count, float *out) {
+  evaluateRow<perlinBlock<Lanes>>(octaves, x, z, count, out);
+}
+
+void perlin(const Octaves &octaves, const double *x, const double *z,
+            const int &count, double *out) {
+  evaluatePoints<perlinBlock<Lanes>>(octaves, x, z, count, out);
+}
+
+float perlin(const Octaves &octaves, const double &x, const double &z) {
+  return evaluate<perlinBlock<1>>(octaves, x, z);
+}
+
+void billow(const Octaves &octaves, const double *x, const double &z,
+            const int &count, float *out) {
+  evaluateRow<billowBlock<Lanes>>(octaves, x, z, count, out);
+}
+
+void billow(const Octaves &octaves, const double *x, const double *z,
+            const int &count, double *out) {
+  evaluatePoints<billowBlock<Lanes>>(octaves, x, z, count, out);
+}
+
+float billow(const Octaves &octaves, const double &x, const double &z) {
+  return evaluate<billowBlock<1>>(octaves, x, z);
+}
+
+void ridgedMulti(const Octaves &octaves, const double *x, const double &z,
+                 const int &count, float *out) {
+  evaluateRow<ridgedMultiBlock<Lanes>>(octaves, x, z, count, out);
+}
+
+void ridgedMulti(const Octaves &octaves, const double *x, const double *z,
+                 const int &count, double *out) {
+  evaluatePoints<ridgedMultiBlock<Lanes>>(octaves, x, z, count, out);
+}
+
+float ridgedMulti(const Octaves &octaves, const double &x, const double &z) {
+  return evaluate<ridgedMultiBlock<1>>(octaves, x, z);
+}
+
+void perlinLayers(const Octaves &octaves, const int &firstOctave,
+                  const double *x, const double &z, const int &count,
+                  const int &stride, double *layers) {
+  evaluateLayers<false>(octaves, firstOctave, x, z, count, stride, layers);
+}
+
+void billowLayers(const Octaves &octaves, const int &firstOctave,
+                  const double *x, const double &z, const int &count,
+                  const int &stride, double *layers) {
+  evaluateLayers<true>(octaves, firstOctave, x, z, count, stride, layers);
+}
+
+void combineLayers(const double &persistence, const int &octaveCount,
+                   const double &offset, const double *layers,
+                   const int &count, float *out) {
+  // octaves are added in the same order and with the same weights as in the
+  // octave loops, so results are identical. Loops over lanes vectorize
+  for (int start = 0; start < count; start += Lanes) {
+    int end = std::min(Lanes, count - start);
+    double value[Lanes] = {};
+    double curPersistence = 1.0;
+    for (int octave = 0; octave < octaveCount; octave++) {
+      const double *layer = layers + octave * count + start;
+      for (int i = 0; i < end; i++) {
+        value[i] += layer[i] * curPersistence;
+      }
+      curPersistence *= persistence;
+    }
+    for (int i = 0; i < end; i++) {
+      out[start + i] = static_cast<float>(value[i] + offset);
+    }
+  }
+}
+
+float random(const int &seed, const int &x, const int &z) {
+  return static_cast<float>(randomHash(seed, x, z) >> 8) / RandomMaximum;
+}
+
+void random(const int &seed, const int &x, const int &z, const int &count,
+            float *out) {
+  for (int i = 0; i < count; i++) {
+    out[i] = static_cast<float>(randomHash(seed, x + i, z) >> 8) /
+             RandomMaximum;
+  }
+}
+
+} // namespace NoiseKernel
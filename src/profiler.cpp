@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+const int Profiler::GpuThread;
+
+Profiler::Profiler()
+    : epoch_(std::chrono::steady_clock::now()),
+      enabled_(false),
+      offset_(0),
+      traceFrames_(0) {
+}
+
+Profiler &Profiler::getShared() {
+  // function-local static is initialized once, even with concurrent callers
+  static Profiler profiler;
+  return profiler;
+}
+
+float Profiler::percentile(const std::vector<float> &sorted,
+                           const float &fraction) {
+  // nearest rank
+  size_t rank = std::ceil(fraction * sorted.size());
+  return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+bool Profiler::isEnabled() {
+  return enabled_;
+}
+
+void Profiler::setEnabled(bool enabled) {
+  enabled_ = enabled;
+}
+
+double Profiler::now() {
+  std::chrono::duration<double, std::micro> time =
+      std::chrono::steady_clock::now() - epoch_;
+  return time.count();
+}
+
+void Profiler::record(const char *name, const double &start,
+                      const double &duration, const int &thread) {
+  if (!enabled_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  frameTotals_[stageIndex(name)] += duration;
+  if (traceFrames_ > 0 && events_.size() < Defaults::MaximumTraceEvents) {
+    events_.push_back(
+        Event{name, thread < 0 ? currentThread() : thread, start, duration});
+  }
+}
+
+void Profiler::endFrame() {
+  if (!enabled_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < names_.size(); i++) {
+    history_[i][offset_] = frameTotals_[i] / 1000.0;
+    frameTotals_[i] = 0.0;
+  }
+  offset_ = (offset_ + 1) % Defaults::FrameTimeHistory;
+
+  // last frame of trace. Writing stalls this frame, but it's not part of the
+  // trace anymore
+  if (traceFrames_ > 0 && --traceFrames_ == 0) {
+    if (writeEvents(tracePath_)) {
+      writtenPath_ = tracePath_;
+    }
+    events_.clear();
+  }
+}
+
+std::vector<Profiler::Stage> Profiler::getStages() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Stage> stages(names_.size());
+  for (size_t i = 0; i < names_.size(); i++) {
+    Stage &stage = stages[i];
+    stage.name = names_[i];
+    stage.history = history_[i];
+    stage.offset = offset_;
+
+    std::vector<float> sorted = stage.history;
+    std::sort(sorted.begin(), sorted.end());
+    stage.median = percentile(sorted, 0.5f);
+    stage.p95 = percentile(sorted, 0.95f);
+    stage.p99 = percentile(sorted, 0.99f);
+    stage.maximum = sorted.back();
+  }
+  return stages;
+}
+
+void Profiler::startTrace(const std::string &path, const int &frameCount) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  tracePath_ = path;
+  traceFrames_ = std::max(frameCount, 1);
+}
+
+bool Profiler::isTracing() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return traceFrames_ > 0;
+}
+
+std::string Profiler::getTracePath() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return writtenPath_;
+}
+
+bool Profiler::writeTrace(const std::string &path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return writeEvents(path);
+}
+
+void Profiler::nameThread(const std::string &name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  threadNames_[currentThread()] = name;
+}
+
+int Profiler::currentThread() {
+  auto thread = threads_.find(std::this_thread::get_id());
+  if (thread != threads_.end()) {
+    return thread->second;
+  }
+  int number = threads_.size() + 1;
+  threads_[std::this_thread::get_id()] = number;
+  return number;
+}
+
+size_t Profiler::stageIndex(const char *name) {
+  // few stages, mostly recorded with the same string literal
+  for (size_t i = 0; i < names_.size(); i++) {
+    if (names_[i] == name || std::strcmp(names_[i], name) == 0) {
+      return i;
+    }
+  }
+  names_.push_back(name);
+  frameTotals_.push_back(0.0);
+  history_.push_back(std::vector<float>(Defaults::FrameTimeHistory, 0.0f));
+  return names_.size() - 1;
+}
+
+bool Profiler::writeEvents(const std::string &path) {
+  // complete events ("ph": "X") with start and duration in microseconds
+  std::ofstream file(path, std::ios::trunc);
+  file << "{\"traceEvents\": [\n";
+  file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+       << GpuThread << ", \"args\": {\"name\": \"GPU\"}}";
+  for (auto &thread : threadNames_) {
+    file << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+         << "\"tid\": " << thread.first << ", \"args\": {\"name\": \""
+         << thread.second << "\"}}";
+  }
+  file.setf(std::ios::fixed);
+  file.precision(3);
+  for (const Event &event : events_) {
+    file << ",\n{\"name\": \"" << event.name
+         << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread
+         << ", \"ts\": " << event.start << ", \"dur\": " << event.duration
+         << "}";
+  }
+  file << "\n], \"displayTimeUnit\": \"ms\"}\n";
+  if (!file) {
+    std::cerr << "Error: can't write trace " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+ScopedTimer::ScopedTimer(const char *name, Profiler &profiler)
+    : name_(name),
+      profiler_(profiler),
+      enabled_(profiler.isEnabled()),
+      start_(0.0) {
+  if (enabled_) {
+    start_ = profiler_.now();
+  }
+}
+
+ScopedTimer::~ScopedTimer() {
+  if (enabled_) {
+    profiler_.record(name_, start_, profiler_.now() - start_);
+  }
+}
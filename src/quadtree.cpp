@@ -19,16 +19,10 @@
 
 #include "quadtree.h"
 
-Quadtree::Quadtree(const int &level, const int &startpoint)
-    : level_(level), startpoint_(startpoint) {
+Quadtree::Quadtree() {
   // A tree data structure in which each node has exactly four children. Used to
   // recursivly partition a tile in different levels of details.
 
-  // Offset/Distance between vertices in this level. Offset on lod 0 is
-  // TileWidth and decreases with every iteration. highest level of detail has
-  // offset of 1.
-  int offset = pow(2, Defaults::MaximumLod - level_);
-
   /*
 
   +---x
@@ -41,63 +35,141 @@ Quadtree::Quadtree(const int &level, const int &startpoint)
 
   */
 
-  indices_ = std::vector<GLuint>(6);
+  unsigned int width = Defaults::TileWidth + 1;
+  size_t nodeCount = getNodeCount();
+  indices_ = std::vector<unsigned int>(6 * nodeCount);
+
+  // startpoint (top left vertex) of each node, filled level by level
+  std::vector<unsigned int> startpoints(nodeCount);
+  startpoints[0] = 0;
+
+  for (int level = 0; level <= Defaults::MaximumLod; level++) {
+    // Offset/Distance between vertices in this level. Offset on lod 0 is
+    // TileWidth and decreases with every level. highest level of detail has
+    // offset of 1.
+    unsigned int offset = Defaults::TileWidth >> level;
+
+    for (size_t node = getLevelStart(level); node < getLevelStart(level + 1);
+         node++) {
+      unsigned int tl = startpoints[node];
+      unsigned int tr = tl + offset;
+      unsigned int bl = tl + width * offset;
+      unsigned int br = bl + offset;
+
+      // left triangle
+      indices_[6 * node + 0] = tl;
+      indices_[6 * node + 1] = bl;
+      indices_[6 * node + 2] = br;
+
+      // right triangle
+      indices_[6 * node + 3] = tl;
+      indices_[6 * node + 4] = br;
+      indices_[6 * node + 5] = tr;
+
+      // add children counterclockwise until we reached MaximumLod
+      if (level < Defaults::MaximumLod) {
+        unsigned int half = offset / 2;
+        startpoints[getChild(node, 0)] = tl;
+        startpoints[getChild(node, 1)] = tl + width * half;
+        startpoints[getChild(node, 2)] = tl + width * half + half;
+        startpoints[getChild(node, 3)] = tl + half;
+      }
+    }
+  }
+}
+
+size_t Quadtree::getNodeCount() {
+  return getLevelStart(Defaults::MaximumLod + 1);
+}
 
-  int tl = startpoint;
-  int tr = startpoint + offset;
-  int bl = tl + (Defaults::TileWidth + 1) * offset;
-  int br = bl + offset;
+size_t Quadtree::getLevelStart(const int &level) {
+  // number of nodes in all levels above: sum of 4^i for i < level
+  return ((static_cast<size_t>(1) << (2 * level)) - 1) / 3;
+}
 
-  // left triangle
-  indices_[0] = tl;
-  indices_[1] = bl;
-  indices_[2] = br;
+int Quadtree::getLevelOfNode(const size_t &node) {
+  int level = 0;
+  while (getLevelStart(level + 1) <= node) {
+    level++;
+  }
+  return level;
+}
 
-  // right triangle
-  indices_[3] = tl;
-  indices_[4] = br;
-  indices_[5] = tr;
+size_t Quadtree::getChild(const size_t &node, const int &child) {
+  return 4 * node + 1 + child;
+}
 
-  // add children until we reached MaximumLod
-  if (level_ < Defaults::MaximumLod) {
-    this->isLeaf_ = false;
+const Quadtree &Quadtree::getShared() {
+  // initialization of local statics is thread-safe, so worker threads and
+  // render thread may ask for it at the same time
+  static const Quadtree quadtree;
+  return quadtree;
+}
 
-    // calculate starting points of children
-    int tlChild = tl;
-    int trChild = tl + offset / 2;
-    int blChild = tl + (Defaults::TileWidth + 1) * offset / 2;
-    int brChild = blChild + offset / 2;
+unsigned int Quadtree::getNodeStartpoint(const size_t &node) const {
+  // top left index of left triangle
+  return indices_[6 * node];
+}
 
-    // add children counterclockwise
-    children_ = std::vector<std::shared_ptr<Quadtree>>(4);
-    int nextLevel = level_ + 1;
+unsigned int Quadtree::getNodeWidth(const size_t &node) const {
+  // top right minus top left
+  return indices_[6 * node + 5] - indices_[6 * node];
+}
 
-    children_[0] = std::shared_ptr<Quadtree>(new Quadtree(nextLevel, tlChild));
-    children_[1] = std::shared_ptr<Quadtree>(new Quadtree(nextLevel, blChild));
-    children_[2] = std::shared_ptr<Quadtree>(new Quadtree(nextLevel, brChild));
-    children_[3] = std::shared_ptr<Quadtree>(new Quadtree(nextLevel, trChild));
+std::vector<unsigned int> Quadtree::getIndicesOfLevel(const int &lod) {
+  // return indices for specified LOD
+  IndexSpan level = getLevel(lod);
+  return std::vector<unsigned int>(level.begin(), level.end());
+}
 
-  } else {
-    isLeaf_ = true;
-  }
+IndexSpan Quadtree::getLevel(const int &lod) const {
+  size_t start = getLevelStart(lod);
+  size_t end = getLevelStart(lod + 1);
+  IndexSpan span = {&indices_[6 * start], 6 * (end - start)};
+  return span;
 }
 
-bool Quadtree::isLeaf() {
-  // a quadtree without children is a leaf
-  return isLeaf_;
+IndexSpan Quadtree::getNodeIndices(const size_t &node, const int &lod) const {
+  // node covers 4^(lod - level) consecutive nodes on level lod
+  int level = getLevelOfNode(node);
+  size_t factor = static_cast<size_t>(1) << (2 * (lod - level));
+  size_t first = getLevelStart(lod) + (node - getLevelStart(level)) * factor;
+  IndexSpan span = {&indices_[6 * first], 6 * factor};
+  return span;
 }
 
-std::vector<GLuint> Quadtree::getIndicesOfLevel(const int &lod) {
-  // return indices for specified LOD
-  if (isLeaf_ || level_ == lod) {
-    return indices_;
+std::vector<NodeBounds> Quadtree::calculateBounds(const float *heights,
+                                                const size_t &stride) const {
+  std::vector<NodeBounds> bounds(getNodeCount());
+
+  // leafs span just one quad, so their bounds are given by their corners
+  for (size_t node = getLevelStart(Defaults::MaximumLod);
+       node < getNodeCount(); node++) {
+    const unsigned int *quad = &indices_[6 * node];
+    unsigned int corners[4] = {quad[0], quad[1], quad[2], quad[5]};
+    NodeBounds nodeBounds = {heights[corners[0] * stride],
+                             heights[corners[0] * stride]};
+    for (unsigned int corner : corners) {
+      nodeBounds.minHeight =
+          std::min(nodeBounds.minHeight, heights[corner * stride]);
+      nodeBounds.maxHeight =
+          std::max(nodeBounds.maxHeight, heights[corner * stride]);
+    }
+    bounds[node] = nodeBounds;
   }
 
-  std::vector<GLuint> indices;
-  for (auto child : children_) {
-    auto i = child->getIndicesOfLevel(lod);
-    indices.insert(indices.cend(), i.cbegin(), i.cend());
+  // inner nodes merge bounds of their children, bottom-up
+  for (size_t node = getLevelStart(Defaults::MaximumLod); node-- > 0;) {
+    NodeBounds nodeBounds = bounds[getChild(node, 0)];
+    for (int child = 1; child < 4; child++) {
+      const NodeBounds &childBounds = bounds[getChild(node, child)];
+      nodeBounds.minHeight =
+          std::min(nodeBounds.minHeight, childBounds.minHeight);
+      nodeBounds.maxHeight =
+          std::max(nodeBounds.maxHeight, childBounds.maxHeight);
+    }
+    bounds[node] = nodeBounds;
   }
 
-  return indices;
+  return bounds;
 }
@@ -65,7 +65,7 @@ void Shader::load(const GLchar *shaderPath, GLenum shaderType) {
   shaderIds_.push_back(shaderId);
 }
 
-void Shader::createProgram() {
+void Shader::link() {
   // Shader program
   program_ = glCreateProgram();
   for (GLuint id : shaderIds_) {
@@ -90,10 +90,13 @@ void Shader::createProgram() {
 }
 
 void Shader::use() {
-  createProgram();
   glUseProgram(program_);
 }
 
 GLuint Shader::getProgram() {
   return program_;
 }
+
+void Shader::cleanup() {
+  glDeleteProgram(program_);
+}
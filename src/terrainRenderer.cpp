@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "terrainRenderer.h"
+
+// binding point of uniform block "Frame"
+static const GLuint FrameBinding = 0;
+
+TerrainRenderer::TerrainRenderer()
+    : batchVAO_(0),
+      heightmapVAO_(0),
+      seaLocation_(-1),
+      seaLevelLocation_(-1),
+      frameBuffer_(0) {
+}
+
+void TerrainRenderer::setup() {
+  // Build and compile our shader program
+  shader_ = std::unique_ptr<Shader>(new Shader());
+  shader_->load("shader/default.vert", GL_VERTEX_SHADER);
+  shader_->load("shader/default.frag", GL_FRAGMENT_SHADER);
+  shader_->link();
+
+  GLuint blockIndex = glGetUniformBlockIndex(shader_->getProgram(), "Frame");
+  glUniformBlockBinding(shader_->getProgram(), blockIndex, FrameBinding);
+
+  // window is not resizable, so projection stays the same
+  frame_.model = glm::translate(glm::mat4(), glm::vec3(-0.5f, 0.0f, -0.5f));
+  frame_.projection = glm::perspective(
+      Defaults::Zoom, static_cast<GLfloat>(Defaults::WindowWidth) /
+                          static_cast<GLfloat>(Defaults::WindowHeight),
+      Defaults::NearPlane, Defaults::FarPlane);
+  frame_.lightPosition = glm::vec4(500.0f, 500.0f, 0.0f, 1.0f);
+  frame_.lightColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+
+  glGenBuffers(1, &frameBuffer_);
+  glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer_);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, FrameBinding, frameBuffer_);
+
+  setupHeightmapShader();
+}
+
+void TerrainRenderer::setupHeightmapShader() {
+  // fragment shader is the same for both modes
+  heightmapShader_ = std::unique_ptr<Shader>(new Shader());
+  heightmapShader_->load("shader/heightmap.vert", GL_VERTEX_SHADER);
+  heightmapShader_->load("shader/default.frag", GL_FRAGMENT_SHADER);
+  heightmapShader_->link();
+
+  GLuint program = heightmapShader_->getProgram();
+  glUniformBlockBinding(program, glGetUniformBlockIndex(program, "Frame"),
+                        FrameBinding);
+
+  // constant uniforms are set once
+  heightmapShader_->use();
+  glUniform1i(glGetUniformLocation(program, "heightmaps"), 0);
+  glUniform1i(glGetUniformLocation(program, "tileWidth"), Defaults::TileWidth);
+  glUniform1f(glGetUniformLocation(program, "maxHeight"),
+              Defaults::MaxMeshHeight);
+  glUniform1f(glGetUniformLocation(program, "skirtDepth"),
+              Defaults::SkirtDepth);
+  seaLocation_ = glGetUniformLocation(program, "sea");
+  seaLevelLocation_ = glGetUniformLocation(program, "seaLevel");
+  glUseProgram(0);
+
+  // vertices have no attributes but the instance data. Position follows from
+  // index alone
+  glGenVertexArrays(1, &heightmapVAO_);
+  glBindVertexArray(heightmapVAO_);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBuffer::getBuffer());
+  glEnableVertexAttribArray(InstanceBatch::Attribute);
+  glVertexAttribDivisor(InstanceBatch::Attribute, 1);
+  glBindVertexArray(0);
+}
+
+void TerrainRenderer::cleanup() {
+  if (shader_) {
+    shader_->cleanup();
+    shader_.reset();
+  }
+  if (frameBuffer_ != 0) {
+    glDeleteBuffers(1, &frameBuffer_);
+    frameBuffer_ = 0;
+  }
+  if (batchVAO_ != 0) {
+    glDeleteVertexArrays(1, &batchVAO_);
+    batchVAO_ = 0;
+  }
+  if (heightmapShader_) {
+    heightmapShader_->cleanup();
+    heightmapShader_.reset();
+  }
+  if (heightmapVAO_ != 0) {
+    glDeleteVertexArrays(1, &heightmapVAO_);
+    heightmapVAO_ = 0;
+  }
+}
+
+void TerrainRenderer::beginFrame(const GLfloat &deltaTime,
+                                 const glm::mat4 &viewMatrix) {
+  rotateLight(deltaTime);
+  frame_.view = viewMatrix;
+
+  glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer_);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame_);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  shader_->use();
+}
+
+glm::mat4 TerrainRenderer::getViewProjection() {
+  return frame_.projection * frame_.view * frame_.model;
+}
+
+void TerrainRenderer::rotateLight(const GLfloat &deltaTime) {
+  glm::mat4 rotationMat(1);
+  rotationMat =
+      glm::rotate(rotationMat, deltaTime * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+  frame_.lightPosition = rotationMat * frame_.lightPosition;
+}
+
+void TerrainRenderer::setVertexBuffer(const GLuint &buffer) {
+  if (batchVAO_ == 0) {
+    glGenVertexArrays(1, &batchVAO_);
+  }
+  glBindVertexArray(batchVAO_);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBuffer::getBuffer());
+
+  // attributes start at beginning of buffer, draws select their slot with a
+  // base vertex
+  Tile::setupVertexAttributes(0);
+
+  // Unbind buffers/arrays to prevent strange bugs
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TerrainRenderer::renderBatches(DrawBatch &terrain, DrawBatch &sea) {
+  glBindVertexArray(batchVAO_);
+  terrain.draw();
+  sea.draw();
+  glBindVertexArray(0);
+}
+
+void TerrainRenderer::renderHeightmaps(InstanceBatch &batch,
+                                       HeightmapPool &heightmaps, bool showSea,
+                                       const float &seaLevel) {
+  batch.upload();
+
+  heightmapShader_->use();
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, heightmaps.getTexture());
+  glBindVertexArray(heightmapVAO_);
+
+  glUniform1i(seaLocation_, GL_FALSE);
+  batch.draw(false);
+
+  // Sea is flat enough to not need skirts
+  if (showSea) {
+    glUniform1i(seaLocation_, GL_TRUE);
+    glUniform1f(seaLevelLocation_, seaLevel);
+    batch.draw(true);
+  }
+
+  glBindVertexArray(0);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
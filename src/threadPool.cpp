@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "threadPool.h"
+
+ThreadPool::ThreadPool(size_t threadCount) : stop_(false) {
+  if (threadCount == 0) {
+    // keep one hardware thread free for rendering
+    size_t hardwareThreads = std::thread::hardware_concurrency();
+    threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+  }
+
+  for (size_t i = 0; i < threadCount; i++) {
+    workers_.push_back(std::thread(&ThreadPool::work, this));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+
+  // workers finish all queued jobs before they return
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::getThreadCount() {
+  return workers_.size();
+}
+
+size_t ThreadPool::getQueuedCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return jobs_.size();
+}
+
+void ThreadPool::work() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        // stop_ is set and nothing left to do
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job();
+  }
+}
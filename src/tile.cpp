@@ -18,221 +18,399 @@
  */
 
 #include "tile.h"
+#include "layerCache.h"
+#include "profiler.h"
+#include "tileCache.h"
+
+// amplitude of waves on sea surface
+static const float WaveHeight = 0.3f;
 
 Tile::Tile(const int &x, const int &z,
-           const std::shared_ptr<NoiseInterface> &noise,
+           const std::shared_ptr<const NoiseInterface> &noise,
            const GLuint &tileWidth)
     : noise_(noise),
+      store_(nullptr),
+      cache_(nullptr),
+      layers_(nullptr),
       tileWidth_(tileWidth),
+      x_(x),
+      z_(z),
       xOffset_(x * Defaults::TileWidth),
       zOffset_(z * Defaults::TileWidth),
-      quadtree_(std::unique_ptr<Quadtree>(new Quadtree)),
-      verticesCount_((tileWidth_ + 1) * (tileWidth_ + 1)) {
+      verticesCount_((tileWidth_ + 1) * (tileWidth_ + 1)),
+      lod_(Defaults::MaximumLod),
+      pool_(nullptr),
+      terrainSlot_(-1),
+      seaSlot_(-1),
+      terrainVAO_(0),
+      seaVAO_(0),
+      heightmaps_(nullptr),
+      layer_(-1),
+      seaLevel_(0.0f),
+      showSea_(false) {
   // initialize tile
-  createVertices();
-  createTerrain();
-  createSea();
+  createHeights();
 }
 
-void Tile::setup() {
-  // setup OpenGl stuff. there must be an opengl context!
-  setupShader();
-  setupBuffers();
+Tile::Tile(TileData &data,
+           const std::shared_ptr<const NoiseInterface> &noise,
+           const GLuint &tileWidth)
+    : noise_(noise),
+      store_(nullptr),
+      cache_(nullptr),
+      layers_(nullptr),
+      tileWidth_(tileWidth),
+      x_(data.x),
+      z_(data.z),
+      xOffset_(data.x * Defaults::TileWidth),
+      zOffset_(data.z * Defaults::TileWidth),
+      verticesCount_((tileWidth_ + 1) * (tileWidth_ + 1)),
+      lod_(Defaults::MaximumLod),
+      pool_(nullptr),
+      terrainSlot_(-1),
+      seaSlot_(-1),
+      terrainVAO_(0),
+      seaVAO_(0),
+      heightmaps_(nullptr),
+      layer_(-1),
+      seaLevel_(0.0f),
+      showSea_(false) {
+  heights_ = std::move(data.heights);
+  bounds_ = std::move(data.bounds);
 }
 
-void Tile::setupShader() {
-  // Build and compile our shader program
-  shader_ = std::unique_ptr<Shader>(new Shader());
-  shader_->load("shader/default.vert", GL_VERTEX_SHADER);
-  shader_->load("shader/default.frag", GL_FRAGMENT_SHADER);
-  shader_->use();
-  lightPos_ = glm::vec3(500.0f, 500.0f, 0.0f);
-  lightColorLoc_ = glGetUniformLocation(shader_->getProgram(), "lightColor");
-  lightPosLoc_ = glGetUniformLocation(shader_->getProgram(), "lightPosition");
-  glUniform3f(lightColorLoc_, 1.0f, 1.0f, 1.0f);
-  glUniform3f(lightPosLoc_, lightPos_.x, lightPos_.y, lightPos_.z);
+void Tile::setup(BufferPool &pool) {
+  // setup OpenGl stuff. there must be an opengl context!
+  pool_ = &pool;
+  terrainSlot_ = pool_->acquire();
+  seaSlot_ = pool_->acquire();
+  setupVertexArray(terrainVAO_, terrainSlot_);
+  setupVertexArray(seaVAO_, seaSlot_);
+  uploadBuffers();
 }
 
-void Tile::setupBuffers() {
-  setupTerrainBuffers();
-  setupSeaBuffers();
+void Tile::setup(HeightmapPool &heightmaps) {
+  // only heights are uploaded, vertex shader builds the mesh from them
+  heightmaps_ = &heightmaps;
+  layer_ = heightmaps_->acquire();
+  uploadBuffers();
 }
 
-// TODO: DRY for buffer setup
-void Tile::setupTerrainBuffers() {
-  // Bind VAO first,
-  glGenVertexArrays(1, &terrainVAO_);
-  glBindVertexArray(terrainVAO_);
+void Tile::setupVertexArray(GLuint &vao, const int &slot) {
+  // vertex arrays are created once per tile and point into the tiles slot of
+  // the shared vertex buffer. Only buffer contents change afterwards
+  size_t slotOffset = pool_->getSlotOffset(slot);
 
-  // then bind and set vertex buffers
-  GLuint terrainVBO; // Vertex Buffer Object
-  glGenBuffers(1, &terrainVBO);
-  glBindBuffer(GL_ARRAY_BUFFER, terrainVBO);
-  glBufferData(GL_ARRAY_BUFFER, verticesCount_ * sizeof(Vertex),
-               &vertices_.front(), GL_STATIC_DRAW);
+  // Bind VAO first,
+  glGenVertexArrays(1, &vao);
+  glBindVertexArray(vao);
 
-  // the element buffer
-  GLuint terrainEBO; // Element Buffer Object
-  glGenBuffers(1, &terrainEBO);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, terrainEBO);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, terrainIndices_.size() * sizeof(GLuint),
-               &terrainIndices_.front(), GL_STATIC_DRAW);
+  // then bind vertex buffer
+  glBindBuffer(GL_ARRAY_BUFFER, pool_->getBuffer());
 
-  // Position attribute
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                        reinterpret_cast<GLvoid *>(0));
+  // the element buffer is shared by all tiles
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBuffer::getBuffer());
 
-  // Color attribute
-  glEnableVertexAttribArray(2);
-  glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                        reinterpret_cast<GLvoid *>(offsetof(Vertex, color)));
+  setupVertexAttributes(slotOffset);
 
   // Unbind buffers/arrays to prevent strange bugs
   glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void Tile::setupSeaBuffers() {
-  // Bind VAO first,
-  glGenVertexArrays(1, &seaVAO_);
-  glBindVertexArray(seaVAO_);
-
-  // then bind and set vertex buffers
-  GLuint seaVBO; // Vertex Buffer Object
-  glGenBuffers(1, &seaVBO);
-  glBindBuffer(GL_ARRAY_BUFFER, seaVBO);
-  glBufferData(GL_ARRAY_BUFFER, seaVertices_.size() * sizeof(Vertex),
-               &seaVertices_.front(), GL_STATIC_DRAW);
-
-  // the element buffer
-  GLuint seaEBO; // Element Buffer Object
-  glGenBuffers(1, &seaEBO);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, seaEBO);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, seaIndices_.size() * sizeof(GLuint),
-               &seaIndices_.front(), GL_STATIC_DRAW);
-
+void Tile::setupVertexAttributes(const size_t &offset) {
   // Position attribute
   glEnableVertexAttribArray(0);
   glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                        reinterpret_cast<GLvoid *>(0));
+                        reinterpret_cast<GLvoid *>(offset));
 
   // Color attribute
   glEnableVertexAttribArray(2);
-  glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                        reinterpret_cast<GLvoid *>(offsetof(Vertex, color)));
-
-  // Unbind buffers/arrays to prevent strange bugs
-  glBindVertexArray(0);
+  glVertexAttribPointer(
+      2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+      reinterpret_cast<GLvoid *>(offset + offsetof(Vertex, color)));
 }
 
-void Tile::update(const GLfloat &deltaTime) {
-  // right now, this just updates the light
-  glm::mat4 rotationMat(1);
-  rotationMat =
-      glm::rotate(rotationMat, deltaTime * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
-  lightPos_ = glm::vec3(rotationMat * glm::vec4(lightPos_, 1.0f));
-  glUniform3f(lightPosLoc_, lightPos_.x, lightPos_.y, lightPos_.z);
+void Tile::uploadBuffers() {
+  ScopedTimer timer("Tile::uploadBuffers");
+  uploadTerrain();
+  uploadSea();
 }
 
-void Tile::render(const glm::mat4 &viewMatrix) {
-  // Projection
-  glm::mat4 projection = glm::perspective(
-      Defaults::Zoom, static_cast<GLfloat>(Defaults::WindowWidth) /
-                          static_cast<GLfloat>(Defaults::WindowHeight),
-      Defaults::NearPlane, Defaults::FarPlane);
+void Tile::uploadTerrain() {
+  if (heightmaps_ != nullptr) {
+    heightmaps_->update(layer_, &heights_.front());
+    return;
+  }
+  if (pool_ == nullptr) {
+    return;
+  }
 
-  // Get the uniform locations
-  GLint modelLoc = glGetUniformLocation(shader_->getProgram(), "model");
-  GLint viewLoc = glGetUniformLocation(shader_->getProgram(), "view");
-  GLint projLoc = glGetUniformLocation(shader_->getProgram(), "projection");
+  // vertices are only needed for uploading, tile keeps just the heights.
+  // skirt vertices follow the grid vertices
+  std::vector<Vertex> vertices = createVertices();
+  std::vector<Vertex> skirtVertices = createSkirts(vertices);
+  size_t verticesSize = vertices.size() * sizeof(Vertex);
+  pool_->update(terrainSlot_, &vertices.front(), verticesSize);
+  pool_->update(terrainSlot_, &skirtVertices.front(),
+                skirtVertices.size() * sizeof(Vertex), verticesSize);
+}
 
-  // Pass the matrices to the shader
-  glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(viewMatrix));
-  glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+void Tile::uploadSea() {
+  // sea of heightmap tiles is created by the vertex shader
+  if (pool_ == nullptr) {
+    return;
+  }
+  std::vector<Vertex> seaVertices = createSea();
+  pool_->update(seaSlot_, &seaVertices.front(),
+                seaVertices.size() * sizeof(Vertex));
+}
+
+size_t Tile::getSlotSize(const GLuint &tileWidth) {
+  // grid vertices and one skirt vertex per border vertex
+  size_t width = tileWidth + 1;
+  return (width * width + 4 * width) * sizeof(Vertex);
+}
 
-  // Calculate the model matrix and pass it to shader before drawing
-  glm::mat4 modelMatrix;
-  modelMatrix = glm::translate(modelMatrix, glm::vec3(-0.5f, 0.0f, -0.5f));
-  glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+void Tile::render() {
+  // program and uniforms are set up by TerrainRenderer
 
-  // Finally, draw tile elements
+  // draw tile elements of current level of detail
+  GLvoid *lodOffset = reinterpret_cast<GLvoid *>(
+      IndexBuffer::getOffset(lod_) * sizeof(GLuint));
   glBindVertexArray(terrainVAO_);
-  glDrawElements(GL_TRIANGLES, terrainIndices_.size(), GL_UNSIGNED_INT,
-                 nullptr);
+  glDrawElements(GL_TRIANGLES, IndexBuffer::getCount(lod_), GL_UNSIGNED_INT,
+                 lodOffset);
   glBindVertexArray(0);
 
-  // Draw sea level
+  // Draw sea level. Sea is flat enough to not need skirts
   if (showSea_) {
     glBindVertexArray(seaVAO_);
-    glDrawElements(GL_TRIANGLES, seaIndices_.size(), GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, IndexBuffer::getGridCount(lod_),
+                   GL_UNSIGNED_INT, lodOffset);
     glBindVertexArray(0);
   }
 }
 
-void Tile::cleanup() {
-  glDeleteVertexArrays(1, &terrainVAO_);
-  glDeleteVertexArrays(1, &seaVAO_);
+void Tile::addToBatch(DrawBatch &terrain, DrawBatch &sea) {
+  // vertices of all slots are addressed through one vertex array, so the
+  // slot is selected with a base vertex
+  GLint terrainBase = pool_->getSlotOffset(terrainSlot_) / sizeof(Vertex);
+  terrain.add(IndexBuffer::getCount(lod_), IndexBuffer::getOffset(lod_),
+              terrainBase);
+
+  if (showSea_) {
+    GLint seaBase = pool_->getSlotOffset(seaSlot_) / sizeof(Vertex);
+    sea.add(IndexBuffer::getGridCount(lod_), IndexBuffer::getOffset(lod_),
+            seaBase);
+  }
 }
 
-void Tile::createVertices() {
+GLuint Tile::addToBatch(DrawBatch &terrain, DrawBatch &sea,
+                        const Frustum &frustum) {
+  if (!isVisible(frustum)) {
+    return 0;
+  }
+  GLuint visible = addVisibleNodes(0, 0, frustum, terrain, sea);
+
+  // skirts follow the grid indices and are drawn as a whole
+  GLint terrainBase = pool_->getSlotOffset(terrainSlot_) / sizeof(Vertex);
+  GLuint gridCount = IndexBuffer::getGridCount(lod_);
+  terrain.add(IndexBuffer::getCount(lod_) - gridCount,
+              IndexBuffer::getOffset(lod_) + gridCount, terrainBase);
+  return visible;
+}
 
-  /*
+GLuint Tile::addVisibleNodes(const size_t &node, const int &level,
+                             const Frustum &frustum, DrawBatch &terrain,
+                             DrawBatch &sea) {
+  Frustum::Result result = frustum.classify(getNodeBox(node));
+  if (result == Frustum::Outside) {
+    return 0;
+  }
 
-   y ^ Right-handed coordinates system. y is height.
-     |
-     |
-     +-----> x
-    /
-  z/
+  // children are not tested if node is completely inside or the current lod
+  // has no finer nodes
+  int deepest = std::min(lod_, Defaults::CullingLevel);
+  if (result == Frustum::Inside || level == deepest) {
+    GLuint count = IndexBuffer::getQuadtree().getNodeIndices(node, lod_).size();
+    GLuint first = IndexBuffer::getNodeOffset(node, lod_);
+    terrain.add(count, first,
+                pool_->getSlotOffset(terrainSlot_) / sizeof(Vertex));
+    if (showSea_) {
+      sea.add(count, first, pool_->getSlotOffset(seaSlot_) / sizeof(Vertex));
+    }
+    return 1 << (2 * (Defaults::CullingLevel - level));
+  }
 
-  the polygon mesh consists of vertices forming a square from (0, y, 0) to
-  (width, y, width) with width*width subtiles. each subtile is split in two
-  triangles from top left to bottom right.
+  GLuint visible = 0;
+  for (int child = 0; child < 4; child++) {
+    visible += addVisibleNodes(Quadtree::getChild(node, child), level + 1,
+                               frustum, terrain, sea);
+  }
+  return visible;
+}
 
-  */
+BoundingBox Tile::getNodeBox(const size_t &node) {
+  const Quadtree &quadtree = IndexBuffer::getQuadtree();
+  GLuint width = tileWidth_ + 1;
+  GLuint start = quadtree.getNodeStartpoint(node);
+  GLfloat nodeWidth = quadtree.getNodeWidth(node);
 
-  // there are (tileWidth + 1)^2 vertices
-  vertices_ = std::vector<Vertex>(verticesCount_);
-  int idx = 0;
+  GLfloat minHeight = bounds_[node].minHeight;
+  GLfloat maxHeight = bounds_[node].maxHeight;
+  if (showSea_) {
+    minHeight = std::min(minHeight, seaLevel_ - WaveHeight);
+    maxHeight = std::max(maxHeight, seaLevel_ + WaveHeight);
+  }
+
+  glm::vec3 minimum(xOffset_ + static_cast<int>(start % width), minHeight,
+                    zOffset_ + static_cast<int>(start / width));
+  glm::vec3 maximum(minimum.x + nodeWidth, maxHeight, minimum.z + nodeWidth);
+  return BoundingBox(minimum, maximum);
+}
+
+BoundingBox Tile::getBoundingBox() {
+  // root node covers whole tile
+  BoundingBox box = getNodeBox(0);
+  glm::vec3 minimum = box.getMinimum();
+  minimum.y -= Defaults::SkirtDepth;
+  return BoundingBox(minimum, box.getMaximum());
+}
+
+bool Tile::isVisible(const Frustum &frustum) {
+  return frustum.classify(getBoundingBox()) != Frustum::Outside;
+}
+
+GLuint Tile::getPatchCount() {
+  return 1 << (2 * Defaults::CullingLevel);
+}
+
+void Tile::addToBatch(InstanceBatch &batch) {
+  // tile has no heightmap if texture array ran out of layers
+  if (layer_ >= 0) {
+    batch.add(lod_, xOffset_, zOffset_, layer_);
+  }
+}
+
+void Tile::cleanup() {
+  if (pool_ != nullptr) {
+    glDeleteVertexArrays(1, &terrainVAO_);
+    glDeleteVertexArrays(1, &seaVAO_);
+    pool_->release(terrainSlot_);
+    pool_->release(seaSlot_);
+  }
+  if (heightmaps_ != nullptr) {
+    heightmaps_->release(layer_);
+  }
+}
+
+void Tile::createHeights() {
+  TileData data = TileGenerator::generate(x_, z_, noise_, tileWidth_, store_,
+                                          cache_, layers_);
+  heights_ = std::move(data.heights);
+  bounds_ = std::move(data.bounds);
+}
+
+std::vector<Vertex> Tile::createVertices() {
+  ScopedTimer timer("Tile::createVertices");
+
+  // x and z follow from index in grid, color from height
   size_t width = tileWidth_ + 1;
-  GLfloat y;
+  std::vector<Vertex> vertices(width * width);
+
+  for (size_t z = 0; z < width; z++) {
+    for (size_t x = 0; x < width; x++) {
+      size_t idx = z * width + x;
+      GLfloat y = heights_[idx];
+      vertices[idx].position =
+          glm::vec3(static_cast<GLfloat>(xOffset_ + static_cast<int>(x)), y,
+                    static_cast<GLfloat>(zOffset_ + static_cast<int>(z)));
+      vertices[idx].color = colorFromHeight(y);
+    }
+  }
+  return vertices;
+}
 
-  // type of z and x is "signed int" instead of "unsigned size_t", so we don't
-  // have to cast back to a signed type before calculating coordinates.
-  for (int z = 0; z < width; z++) {
-    for (int x = 0; x < width; x++) {
-      idx = z * width + x;
+void Tile::setStore(TileStore *store) {
+  store_ = store;
+}
 
-      int worldX = xOffset_ + x;
-      int worldZ = zOffset_ + z;
+void Tile::setCache(TileCache *cache) {
+  cache_ = cache;
+}
 
-      // use world space coordinates of x and z to create height generated with
-      // noise algorithm
-      y = (noise_->getValue(worldX, 0.0f, worldZ) + 1) / 2 *
-          Defaults::MaxMeshHeight;
+void Tile::setLayerCache(LayerCache *layers) {
+  layers_ = layers;
+}
 
-      // set position
-      vertices_[idx].position =
-          glm::vec3(static_cast<GLfloat>(worldX), static_cast<GLfloat>(y),
-                    static_cast<GLfloat>(worldZ));
+void Tile::applyData(TileData &data) {
+  x_ = data.x;
+  z_ = data.z;
+  xOffset_ = data.x * Defaults::TileWidth;
+  zOffset_ = data.z * Defaults::TileWidth;
+  heights_ = std::move(data.heights);
+  bounds_ = std::move(data.bounds);
+  uploadBuffers();
+}
 
-      // set color
-      vertices_[idx].color = colorFromHeight(y);
+std::vector<Vertex> Tile::createSkirts(const std::vector<Vertex> &vertices) {
+  // one skirt vertex below each border vertex. Border order: north (z = 0),
+  // south (z = tileWidth), west (x = 0), east (x = tileWidth)
+  size_t width = tileWidth_ + 1;
+  std::vector<Vertex> skirtVertices(4 * width);
+
+  for (size_t i = 0; i < width; i++) {
+    size_t border[4] = {i, tileWidth_ * width + i, i * width,
+                        i * width + tileWidth_};
+    for (size_t edge = 0; edge < 4; edge++) {
+      Vertex vertex = vertices[border[edge]];
+      vertex.position.y -= Defaults::SkirtDepth;
+      skirtVertices[edge * width + i] = vertex;
     }
   }
+  return skirtVertices;
+}
+
+void Tile::setLod(const int &lod) {
+  lod_ = std::max(0, std::min(lod, Defaults::MaximumLod));
 }
 
-void Tile::createTerrain() {
-  terrainIndices_ = quadtree_->getIndicesOfLevel(Defaults::MaximumLod);
+int Tile::getLod() {
+  return lod_;
+}
+
+int Tile::selectLod(const float &distance) {
+  // level of detail drops by one every time distance doubles
+  if (distance < Defaults::LodDistance) {
+    return Defaults::MaximumLod;
+  }
+  int lod = Defaults::MaximumLod -
+            static_cast<int>(std::log2(distance / Defaults::LodDistance)) - 1;
+  return std::max(lod, Defaults::MinimumLod);
+}
+
+float Tile::distanceTo(const glm::vec3 &position) {
+  // clamp position into the tiles bounds to get closest point. Height bounds
+  // of whole tile are the bounds of the quadtree root
+  glm::vec3 minimum(xOffset_, bounds_[0].minHeight, zOffset_);
+  glm::vec3 maximum(xOffset_ + tileWidth_, bounds_[0].maxHeight,
+                    zOffset_ + tileWidth_);
+  glm::vec3 closest = glm::clamp(position, minimum, maximum);
+  return glm::distance(position, closest);
+}
+
+GLuint Tile::getTriangleCount() {
+  return IndexBuffer::getCount(lod_) / 3;
 }
 
 void Tile::setShowSea(bool showSea) {
   showSea_ = showSea;
 }
 
-void Tile::createSea() {
+std::vector<Vertex> Tile::createSea() {
   // create seaVertices
-  seaVertices_ = std::vector<Vertex>(verticesCount_);
+  std::vector<Vertex> seaVertices(verticesCount_);
 
   int idx = 0;
   size_t width = tileWidth_ + 1;
@@ -248,21 +426,20 @@ void Tile::createSea() {
       int worldZ = zOffset_ + z;
 
       // just to get some coherent height into it.
-      float yOffset = 0.3 * std::sin(1.2 * worldX) * std::sin(1.3 * worldZ);
+      float yOffset =
+          WaveHeight * std::sin(1.2 * worldX) * std::sin(1.3 * worldZ);
 
       // set position
-      seaVertices_[idx].position =
+      seaVertices[idx].position =
           glm::vec3(static_cast<GLfloat>(worldX),
                     static_cast<GLfloat>(seaLevel_ + yOffset),
                     static_cast<GLfloat>(worldZ));
 
       // set color
-      seaVertices_[idx].color = glm::vec3{0.0f, 0.5f, 1.0f};
+      seaVertices[idx].color = glm::vec3{0.0f, 0.5f, 1.0f};
     }
   }
-
-  // create seaIndices
-  seaIndices_ = terrainIndices_;
+  return seaVertices;
 }
 
 glm::vec3 Tile::colorFromHeight(const GLfloat &height) {
@@ -288,77 +465,139 @@ glm::vec3 Tile::colorFromHeight(const GLfloat &height) {
   return color;
 }
 
+const std::vector<NodeBounds> &Tile::getBounds() {
+  return bounds_;
+}
+
+const std::vector<GLfloat> &Tile::getHeights() {
+  return heights_;
+}
+
 std::vector<Vertex> Tile::getVertices() {
   // used for testing
-  return vertices_;
+  return createVertices();
 }
 
 std::vector<GLuint> Tile::getIndices() {
-  // used for testing
-  return terrainIndices_;
+  // used for testing. Indices of grid at highest level of detail
+  auto start = IndexBuffer::getIndices().begin() +
+               IndexBuffer::getOffset(Defaults::MaximumLod);
+  return std::vector<GLuint>(
+      start, start + IndexBuffer::getGridCount(Defaults::MaximumLod));
 }
 
-void Tile::updateCoordinates(const int &x, const int &z) {
-  xOffset_ = x * Defaults::TileWidth;
-  zOffset_ = z * Defaults::TileWidth;
-  createVertices();
-  createTerrain();
-  createSea();
-  setupBuffers();
+// mark job of flag as superseded and replace flag for the next job
+static std::shared_ptr<std::atomic<bool>>
+supersede(std::shared_ptr<std::atomic<bool>> &flag) {
+  if (flag) {
+    *flag = true;
+  }
+  flag = std::make_shared<std::atomic<bool>>(false);
+  return flag;
 }
 
-void Tile::changeAlgorithm(const std::shared_ptr<NoiseInterface> noise) {
-  noise_ = noise;
-  createVertices();
-  createTerrain();
-  setupBuffers();
+void Tile::requestCoordinates(const int &x, const int &z, ThreadPool &pool) {
+  // a previous job is superseded. Its result is simply never picked up and
+  // it is skipped if it is still queued
+  pendingX_ = x;
+  pendingZ_ = z;
+  if (previewJob_.valid() && (x != previewX_ || z != previewZ_)) {
+    // preview of tile that left the view
+    *previewSuperseded_ = true;
+    previewJob_ = std::future<TileData>();
+  }
+  std::shared_ptr<const NoiseInterface> noise = noise_;
+  TileStore *store = store_;
+  TileCache *cache = cache_;
+  LayerCache *layers = layers_;
+  GLuint tileWidth = tileWidth_;
+  std::shared_ptr<std::atomic<bool>> superseded = supersede(jobSuperseded_);
+  pendingJob_ = pool.submit(
+      [x, z, noise, tileWidth, store, cache, layers, superseded]() {
+        if (*superseded) {
+          return TileData();
+        }
+        return TileGenerator::generate(x, z, noise, tileWidth, store, cache,
+                                       layers);
+      });
 }
 
-void Tile::setSeaLevel(const float &seaLevel) {
-  seaLevel_ = seaLevel;
-  createSea();
-  setupSeaBuffers();
+void Tile::requestPreview(const std::shared_ptr<const NoiseInterface> noise,
+                          ThreadPool &pool) {
+  int x = hasPendingJob() ? pendingX_ : x_;
+  int z = hasPendingJob() ? pendingZ_ : z_;
+  previewX_ = x;
+  previewZ_ = z;
+  TileCache *cache = cache_;
+  GLuint tileWidth = tileWidth_;
+  std::shared_ptr<std::atomic<bool>> superseded =
+      supersede(previewSuperseded_);
+  previewJob_ = pool.submit([x, z, noise, tileWidth, cache, superseded]() {
+    if (*superseded) {
+      return TileData();
+    }
+    return TileGenerator::generatePreview(x, z, noise, tileWidth, cache);
+  });
 }
 
-float Tile::getSeaLevel() {
-  return seaLevel_;
+void Tile::requestAlgorithm(const std::shared_ptr<const NoiseInterface> noise,
+                            ThreadPool &pool) {
+  noise_ = noise;
+
+  // regenerate target coordinates of a pending job, not the current ones
+  if (hasPendingJob()) {
+    requestCoordinates(pendingX_, pendingZ_, pool);
+  } else {
+    requestCoordinates(x_, z_, pool);
+  }
 }
 
-float Tile::getHeightAtNeighborIndex(const int &curIdx,
-                                     const int &neighborIdx) {
-  // return height at neighborIdx
+static bool isReady(const std::future<TileData> &job) {
+  return job.valid() &&
+         job.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
 
-  if (neighborIdx >= 0 && neighborIdx < verticesCount_) {
-    // neighborIdx is on same tile, just return height from vertices_
-    return vertices_[neighborIdx].position.y;
+bool Tile::applyFinishedJob() {
+  if (isReady(pendingJob_)) {
+    // full tile replaces preview, even one not shown yet
+    if (previewJob_.valid()) {
+      *previewSuperseded_ = true;
+      previewJob_ = std::future<TileData>();
+    }
+    TileData data = pendingJob_.get();
+    applyData(data);
+    return true;
+  }
+  if (isReady(previewJob_)) {
+    TileData data = previewJob_.get();
+    applyData(data);
+    return true;
   }
+  return false;
+}
 
-  // neighborIdx is on another tile, calculate coordinates and return height
-  glm::vec3 coordinates = calculateCoordinates(curIdx, neighborIdx);
-  return (noise_->getValue(coordinates.x, 0.0f, coordinates.z) + 1) / 2 *
-         Defaults::MaxMeshHeight;
+bool Tile::hasPendingJob() {
+  return pendingJob_.valid();
 }
 
-glm::vec3 Tile::calculateCoordinates(const int &curIdx,
-                                     const int &neighborIdx) {
-  float x = 0.0f;
-  float z = 0.0f;
-  int difference = neighborIdx - curIdx;
+bool Tile::hasPendingPreview() {
+  return previewJob_.valid();
+}
 
-  if (difference < 1) {
-    x = vertices_[curIdx].position.x + difference + tileWidth_ + 1;
-    z = vertices_[curIdx].position.z - 1;
+void Tile::waitForPendingJob() {
+  if (previewJob_.valid()) {
+    previewJob_.wait();
   }
-
-  if (1 == abs(difference)) {
-    x = vertices_[curIdx].position.x + difference;
-    z = vertices_[curIdx].position.z;
+  if (pendingJob_.valid()) {
+    pendingJob_.wait();
   }
+}
 
-  if (difference > 1) {
-    x = vertices_[curIdx].position.x + difference - tileWidth_ - 1;
-    z = vertices_[curIdx].position.z + 1;
-  }
+void Tile::setSeaLevel(const float &seaLevel) {
+  seaLevel_ = seaLevel;
+  uploadSea();
+}
 
-  return glm::vec3(x, 0.0f, z);
+float Tile::getSeaLevel() {
+  return seaLevel_;
 }
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "threadPool.h"
+#include "tileBaker.h"
+#include "tileCache.h"
+#include "tileGenerator.h"
+
+// "LLTC", first bytes of every container file
+static const uint32_t Magic = 0x43544c4c;
+// increase when layout of container files changes
+static const uint32_t Version = 1;
+static const uint16_t MaximumValue = 0xffff;
+
+// tiles generated or waiting to be written per thread
+static const size_t TilesPerThread = 4;
+
+// container file is a header followed by columns x rows tiles of width^2 16
+// bit heights each, row by row
+struct ContainerHeader {
+  uint32_t magic;
+  uint32_t version;
+  int32_t algorithm;
+  NoiseOptions options;
+  int32_t x;
+  int32_t z;
+  int32_t columns;
+  int32_t rows;
+  uint32_t width;
+  float maximumHeight;
+};
+
+// describe region of raw tiles in a text file of directory
+static bool writeRegion(const std::string &directory,
+                        const NoiseInterface &noise, const TileRegion &region,
+                        const unsigned int &width) {
+  NoiseOptions options = noise.getOptions();
+  std::ofstream file(directory + "/region", std::ios::trunc);
+  file << "algorithm " << noise.getAlgorithm() << "\n"
+       << "frequency " << options.frequency << "\n"
+       << "lacunarity " << options.lacunarity << "\n"
+       << "octaveCount " << options.octaveCount << "\n"
+       << "persistence " << options.persistence << "\n"
+       << "seed " << options.seed << "\n"
+       << "x " << region.x << "\nz " << region.z << "\n"
+       << "columns " << region.columns << "\nrows " << region.rows << "\n"
+       << "width " << width << "\n"
+       << "maximumHeight " << Defaults::MaxMeshHeight << "\n";
+  return static_cast<bool>(file);
+}
+
+TileBaker::TileBaker(const std::shared_ptr<const NoiseInterface> &noise,
+                     const unsigned int &tileWidth)
+    : noise_(noise), tileWidth_(tileWidth), tileCount_(0), seconds_(0.0) {
+}
+
+bool TileBaker::bake(const TileRegion &region, const std::string &path,
+                     const Format &format, const size_t &threadCount) {
+  tileCount_ = 0;
+  seconds_ = 0.0;
+  if (region.columns <= 0 || region.rows <= 0) {
+    std::cerr << "Error: region to bake is empty" << std::endl;
+    return false;
+  }
+  auto start = std::chrono::steady_clock::now();
+  unsigned int width = tileWidth_ + 1;
+
+  std::ofstream container;
+  if (format == Container) {
+    container.open(path, std::ios::binary | std::ios::trunc);
+    ContainerHeader header;
+    header.magic = Magic;
+    header.version = Version;
+    header.algorithm = noise_->getAlgorithm();
+    header.options = noise_->getOptions();
+    header.x = region.x;
+    header.z = region.z;
+    header.columns = region.columns;
+    header.rows = region.rows;
+    header.width = width;
+    header.maximumHeight = Defaults::MaxMeshHeight;
+    container.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!container) {
+      std::cerr << "Error: can't write " << path << std::endl;
+      return false;
+    }
+  } else {
+#ifdef _WIN32
+    int result = _mkdir(path.c_str());
+#else
+    int result = mkdir(path.c_str(), 0755);
+#endif
+    if ((result != 0 && errno != EEXIST) ||
+        !writeRegion(path, *noise_, region, width)) {
+      std::cerr << "Error: can't write to directory " << path << std::endl;
+      return false;
+    }
+  }
+
+  // all hardware threads, writing tiles is cheap compared to generation
+  size_t threads = threadCount;
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  size_t window = TilesPerThread * threads;
+  size_t total = static_cast<size_t>(region.columns) * region.rows;
+
+  // tiles are submitted row by row, so west and north neighbours are usually
+  // in cache and shared borders are copied instead of generated again.
+  // Declared before pool, so it outlives running jobs
+  TileCache cache(region.columns + window + 1);
+  ThreadPool pool(threads);
+  std::deque<std::future<TileData>> pending;
+  size_t submitted = 0;
+  bool written = true;
+  std::vector<uint16_t> values(width * width);
+
+  while (written && tileCount_ < total) {
+    // keep window of jobs running, results are written in submission order
+    while (submitted < total && pending.size() < window) {
+      int x = region.x + submitted % region.columns;
+      int z = region.z + submitted / region.columns;
+      std::shared_ptr<const NoiseInterface> noise = noise_;
+      unsigned int tileWidth = tileWidth_;
+      TileCache *tiles = &cache;
+      pending.push_back(pool.submit([x, z, noise, tileWidth, tiles]() {
+        return TileGenerator::generate(x, z, noise, tileWidth, nullptr,
+                                       tiles);
+      }));
+      submitted++;
+    }
+
+    TileData data = pending.front().get();
+    pending.pop_front();
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = quantize(data.heights[i]);
+    }
+    const char *bytes = reinterpret_cast<const char *>(&values.front());
+    size_t size = values.size() * sizeof(uint16_t);
+
+    if (format == Container) {
+      written = static_cast<bool>(container.write(bytes, size));
+    } else {
+      std::string name = path + "/tile_" + std::to_string(data.x) + "_" +
+                         std::to_string(data.z) + ".r16";
+      std::ofstream file(name, std::ios::binary | std::ios::trunc);
+      written = static_cast<bool>(file.write(bytes, size));
+    }
+    if (!written) {
+      std::cerr << "Error: can't write tile " << data.x << ", " << data.z
+                << " to " << path << std::endl;
+      break;
+    }
+
+    tileCount_++;
+    if (progress_) {
+      progress_(tileCount_, total);
+    }
+  }
+
+  // remaining jobs of a failed bake finish with the pool
+  std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start;
+  seconds_ = seconds.count();
+  return written;
+}
+
+void TileBaker::setProgress(const Progress &progress) {
+  progress_ = progress;
+}
+
+size_t TileBaker::getTileCount() {
+  return tileCount_;
+}
+
+double TileBaker::getSeconds() {
+  return seconds_;
+}
+
+double TileBaker::getTilesPerSecond() {
+  return seconds_ > 0.0 ? tileCount_ / seconds_ : 0.0;
+}
+
+uint16_t TileBaker::quantize(const float &height) {
+  float value = height / Defaults::MaxMeshHeight * MaximumValue;
+  return std::lround(std::min(std::max(value, 0.0f),
+                              static_cast<float>(MaximumValue)));
+}
+
+float TileBaker::dequantize(const uint16_t &value) {
+  return static_cast<float>(value) / MaximumValue * Defaults::MaxMeshHeight;
+}
+
+bool TileBaker::readTile(const std::string &path, const int &x, const int &z,
+                         std::vector<float> &heights) {
+  std::ifstream file(path, std::ios::binary);
+  ContainerHeader header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      header.magic != Magic || header.version != Version) {
+    return false;
+  }
+  int column = x - header.x;
+  int row = z - header.z;
+  if (column < 0 || column >= header.columns || row < 0 ||
+      row >= header.rows) {
+    return false;
+  }
+
+  size_t count = header.width * header.width;
+  size_t index = static_cast<size_t>(row) * header.columns + column;
+  std::vector<uint16_t> values(count);
+  file.seekg(sizeof(header) + index * count * sizeof(uint16_t));
+  if (!file.read(reinterpret_cast<char *>(&values.front()),
+                 count * sizeof(uint16_t))) {
+    return false;
+  }
+  heights.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    heights[i] = values[i] * header.maximumHeight / MaximumValue;
+  }
+  return true;
+}
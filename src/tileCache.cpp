@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tileCache.h"
+
+TileCache::TileCache(const size_t &maximumBytes)
+    : maximumBytes_(maximumBytes), bytes_(0), hits_(0), misses_(0) {
+}
+
+bool TileCache::find(const TileKey &key, const size_t &count,
+                     TileData &data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry = entries_.find(key.hash());
+  // different keys may share a hash
+  if (entry == entries_.end() || !(entry->second.key == key) ||
+      entry->second.data->heights.size() != count) {
+    misses_++;
+    return false;
+  }
+  hits_++;
+  usage_.splice(usage_.begin(), usage_, entry->second.position);
+  data = *entry->second.data;
+  return true;
+}
+
+std::shared_ptr<const TileData> TileCache::peek(const TileKey &key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry = entries_.find(key.hash());
+  if (entry == entries_.end() || !(entry->second.key == key)) {
+    return nullptr;
+  }
+  return entry->second.data;
+}
+
+void TileCache::insert(const TileKey &key, const TileData &data) {
+  // tiles are immutable once cached, so peek() can hand them out unlocked
+  std::shared_ptr<const TileData> tile(new TileData(data));
+  uint64_t hash = key.hash();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry = entries_.find(hash);
+  if (entry != entries_.end()) {
+    // replace tile, also one of another key with same hash
+    bytes_ -= getBytes(*entry->second.data);
+    entry->second.key = key;
+    entry->second.data = tile;
+    usage_.splice(usage_.begin(), usage_, entry->second.position);
+  } else {
+    usage_.push_front(hash);
+    entries_.insert(std::make_pair(hash, Entry{key, tile, usage_.begin()}));
+  }
+  bytes_ += getBytes(*tile);
+  evict();
+}
+
+void TileCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  usage_.clear();
+  entries_.clear();
+  bytes_ = 0;
+}
+
+void TileCache::setMaximumBytes(const size_t &maximumBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  maximumBytes_ = maximumBytes;
+  evict();
+}
+
+size_t TileCache::getMaximumBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return maximumBytes_;
+}
+
+size_t TileCache::getBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+size_t TileCache::getSize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+size_t TileCache::getHits() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+size_t TileCache::getMisses() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+size_t TileCache::getBytes(const TileData &data) {
+  return data.heights.size() * sizeof(float) +
+         data.bounds.size() * sizeof(NodeBounds);
+}
+
+void TileCache::evict() {
+  while (bytes_ > maximumBytes_ && !usage_.empty()) {
+    auto entry = entries_.find(usage_.back());
+    bytes_ -= getBytes(*entry->second.data);
+    entries_.erase(entry);
+    usage_.pop_back();
+  }
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tileGenerator.h"
+
+#include <algorithm>
+
+#include "layerCache.h"
+#include "profiler.h"
+#include "tileCache.h"
+#include "tileStore.h"
+
+// copy border of tile x, z shared with neighbour x + dx, z + dz from cache.
+// Returns 1 if neighbour was found, 0 otherwise
+static int copyEdge(const NoiseInterface &noise, TileCache &cache,
+                    const int &x, const int &z, const int &dx, const int &dz,
+                    const size_t &width, std::vector<float> &heights) {
+  std::shared_ptr<const TileData> neighbour =
+      cache.peek(TileKey(noise, x + dx, z + dz));
+  if (!neighbour || neighbour->heights.size() != heights.size()) {
+    return 0;
+  }
+
+  // e.g. east border (last column) of west neighbour is first column of tile
+  size_t last = width - 1;
+  for (size_t i = 0; i < width; i++) {
+    if (dx != 0) {
+      size_t column = dx < 0 ? 0 : last;
+      heights[i * width + column] =
+          neighbour->heights[i * width + last - column];
+    } else {
+      size_t row = dz < 0 ? 0 : last;
+      heights[row * width + i] = neighbour->heights[(last - row) * width + i];
+    }
+  }
+  return 1;
+}
+
+TileData
+TileGenerator::generate(const int &x, const int &z,
+                        const std::shared_ptr<const NoiseInterface> &noise,
+                        const unsigned int &tileWidth, TileStore *store,
+                        TileCache *cache, LayerCache *layers) {
+  ScopedTimer timer("TileGenerator::generate");
+
+  /*
+
+   y ^ Right-handed coordinates system. y is height.
+     |
+     |
+     +-----> x
+    /
+  z/
+
+  the polygon mesh consists of vertices forming a square from (0, y, 0) to
+  (width, y, width) with width*width subtiles. each subtile is split in two
+  triangles from top left to bottom right.
+
+  only the heights are generated, row by row. x and z of a vertex follow from
+  its index, color from its height.
+
+  */
+
+  // there are (tileWidth + 1)^2 vertices
+  size_t width = tileWidth + 1;
+  TileData data;
+  TileKey key(*noise, x, z);
+  if (cache != nullptr && cache->find(key, width * width, data)) {
+    return data;
+  }
+  data.x = x;
+  data.z = z;
+
+  if (store == nullptr || !store->load(key, width * width, data.heights)) {
+    data.heights = std::vector<float>(width * width);
+    int xOffset = x * Defaults::TileWidth;
+    int zOffset = z * Defaults::TileWidth;
+
+    // octave layers give whole tile. Otherwise borders are shared with
+    // neighbours: copy them from neighbours in cache instead of evaluating
+    // them again
+    int west = 0, east = 0, north = 0, south = 0;
+    bool layered = layers != nullptr &&
+                   layers->fillHeights(*noise, x, z, width,
+                                       &data.heights.front());
+    if (!layered && cache != nullptr) {
+      west = copyEdge(*noise, *cache, x, z, -1, 0, width, data.heights);
+      east = copyEdge(*noise, *cache, x, z, 1, 0, width, data.heights);
+      north = copyEdge(*noise, *cache, x, z, 0, -1, width, data.heights);
+      south = copyEdge(*noise, *cache, x, z, 0, 1, width, data.heights);
+    }
+
+    // use world space coordinates of x and z to create heights generated with
+    // noise algorithm, all remaining rows in one batch
+    int columns = width - west - east;
+    int rows = width - north - south;
+    float *start = &data.heights[north * width + west];
+    if (!layered) {
+      noise->fillHeights(xOffset + west, zOffset + north, columns, rows,
+                         width, start);
+    }
+    for (int row = 0; row < rows; row++) {
+      for (int column = 0; column < columns; column++) {
+        float &height = start[row * width + column];
+        height = (height + 1) / 2 * Defaults::MaxMeshHeight;
+      }
+    }
+    if (store != nullptr) {
+      store->save(key, data.heights);
+    }
+  }
+
+  data.bounds =
+      Quadtree::getShared().calculateBounds(&data.heights.front());
+
+  if (cache != nullptr) {
+    cache->insert(key, data);
+  }
+  return data;
+}
+
+TileData TileGenerator::generatePreview(
+    const int &x, const int &z,
+    const std::shared_ptr<const NoiseInterface> &noise,
+    const unsigned int &tileWidth, TileCache *cache) {
+  size_t width = tileWidth + 1;
+  if (cache != nullptr) {
+    std::shared_ptr<const TileData> tile = cache->peek(TileKey(*noise, x, z));
+    if (tile && tile->heights.size() == width * width) {
+      return *tile;
+    }
+  }
+
+  TileData data;
+  data.x = x;
+  data.z = z;
+  int xOffset = x * Defaults::TileWidth;
+  int zOffset = z * Defaults::TileWidth;
+
+  // coarse grid of samples. Borders are sampled at the same vertices as those
+  // of neighbouring previews, so there are no cracks between them
+  int step = std::min(Defaults::PreviewStep, tileWidth);
+  int samplesWidth = tileWidth / step + 1;
+  std::vector<float> samples(samplesWidth * samplesWidth);
+  for (int row = 0; row < samplesWidth; row++) {
+    for (int column = 0; column < samplesWidth; column++) {
+      float value = noise->getValue(xOffset + column * step, 0.0f,
+                                      zOffset + row * step);
+      samples[row * samplesWidth + column] =
+          (value + 1) / 2 * Defaults::MaxMeshHeight;
+    }
+  }
+
+  // interpolate heights of all vertices between samples
+  data.heights = std::vector<float>(width * width);
+  for (size_t z = 0; z < width; z++) {
+    int row = std::min<int>(z / step, samplesWidth - 2);
+    float v = static_cast<float>(z - row * step) / step;
+    for (size_t x = 0; x < width; x++) {
+      int column = std::min<int>(x / step, samplesWidth - 2);
+      float u = static_cast<float>(x - column * step) / step;
+      const float *sample = &samples[row * samplesWidth + column];
+      float north = sample[0] + (sample[1] - sample[0]) * u;
+      float south = sample[samplesWidth] +
+                      (sample[samplesWidth + 1] - sample[samplesWidth]) * u;
+      data.heights[z * width + x] = north + (south - north) * v;
+    }
+  }
+
+  data.bounds =
+      Quadtree::getShared().calculateBounds(&data.heights.front());
+  return data;
+}
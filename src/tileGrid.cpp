@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tileGrid.h"
+
+#include <cstdlib>
+
+TileGrid::TileGrid(const int &radius, const int &centerX, const int &centerZ)
+    : radius_(radius),
+      size_(2 * radius + 1),
+      centerX_(centerX),
+      centerZ_(centerZ) {
+}
+
+int TileGrid::getRadius() const {
+  return radius_;
+}
+
+int TileGrid::getSize() const {
+  return size_;
+}
+
+size_t TileGrid::getSlotCount() const {
+  return size_ * size_;
+}
+
+int TileGrid::getCenterX() const {
+  return centerX_;
+}
+
+int TileGrid::getCenterZ() const {
+  return centerZ_;
+}
+
+size_t TileGrid::slot(const int &x, const int &z) const {
+  // modulo of negative coordinates is negative in C++, shift it back
+  int slotX = ((x % size_) + size_) % size_;
+  int slotZ = ((z % size_) + size_) % size_;
+  return slotZ * size_ + slotX;
+}
+
+bool TileGrid::contains(const int &x, const int &z) const {
+  return std::abs(x - centerX_) <= radius_ && std::abs(z - centerZ_) <= radius_;
+}
+
+std::vector<TileCoordinates> TileGrid::getTiles() const {
+  std::vector<TileCoordinates> tiles;
+  tiles.reserve(getSlotCount());
+  for (int z = centerZ_ - radius_; z <= centerZ_ + radius_; z++) {
+    for (int x = centerX_ - radius_; x <= centerX_ + radius_; x++) {
+      tiles.push_back(TileCoordinates{x, z});
+    }
+  }
+  return tiles;
+}
+
+std::vector<TileCoordinates> TileGrid::moveTo(const int &x, const int &z) {
+  std::vector<TileCoordinates> exposed;
+  for (int row = z - radius_; row <= z + radius_; row++) {
+    bool rowWasVisible = std::abs(row - centerZ_) <= radius_;
+
+    for (int column = x - radius_; column <= x + radius_; column++) {
+      if (rowWasVisible && std::abs(column - centerX_) <= radius_) {
+        // jump to last column of old grid, tile is still in view
+        column = centerX_ + radius_;
+        continue;
+      }
+      exposed.push_back(TileCoordinates{column, row});
+    }
+  }
+
+  centerX_ = x;
+  centerZ_ = z;
+  return exposed;
+}
@@ -19,143 +19,219 @@
 
 #include "tileManager.h"
 
-void TileManager::initialize(const glm::vec3 &currentPos) {
+#include "profiler.h"
+
+void TileManager::initialize(const glm::vec3 &currentPos,
+                             const std::string &storeDirectory) {
   currentPos_ = currentPos;
-  previousPos_ = currentPos;
 
   // default algorithm for terrain generation is PerlinNoise
   currentAlgorithm_ = Defaults::Perlin;
-  noise_ = std::shared_ptr<NoiseInterface>(new PerlinNoise);
+  noise_ = NoiseInterface::create(Defaults::Perlin);
   // add to cache
   noiseCache_[Defaults::Perlin] = noise_;
+  optionsChanged_ = false;
+  // octave layers need a lot of memory, they are enabled in the GUI
+  layers_.setMaximumBytes(0);
   seaLevel_ = Defaults::MaxMeshHeight / 5;
   showSea_ = true;
+  viewRadius_ = Defaults::ViewRadius;
+  lodEnabled_ = true;
+  triangleCount_ = 0;
+  batched_ = true;
+  drawCalls_ = 0;
+  heightmapMode_ = false;
+  cullingEnabled_ = true;
+  visibleTiles_ = 0;
+  visiblePatches_ = 0;
+  requestedTiles_ = 0;
+  appliedTiles_ = 0;
 
-  // create first nine tiles, from (0,0) to (2,2)
-  //
-  // order of for-loops matters
-  // +----- x
-  // |0 1 2
-  // |3 4 5
-  // |6 7 8
-  // z
-
-  for (int z = 0; z < 3; z++) {
-    for (int x = 0; x < 3; x++) {
-      std::unique_ptr<Tile> tile(new Tile(x, z, noise_));
-      tile->setup();
-      tile->setSeaLevel(seaLevel_);
-      tile->setShowSea(showSea_);
-      tiles_.push_back(std::move(tile));
-    }
+  // tiles are generated without store if it can't be opened
+  if (!storeDirectory.empty()) {
+    store_.open(storeDirectory, Defaults::TileStoreBytes);
   }
+
+  renderer_.setup();
+  createTiles();
 }
 
-void TileManager::update(glm::vec3 const &currentPos_) {
-  int currentTileX = std::floor(currentPos_.x / Defaults::TileWidth);
-  int currentTileZ = std::floor(currentPos_.z / Defaults::TileWidth);
-  int diffX = currentTileX - std::floor(previousPos_.x / Defaults::TileWidth);
-  int diffZ = currentTileZ - std::floor(previousPos_.z / Defaults::TileWidth);
-
-  previousPos_ = currentPos_;
-
-  // order of tiles in std::shared_ptr<Tile> tile_:
-  // +----- x
-  // |0 1 2
-  // |3 4 5
-  // |6 7 8
-  // z
-  //
-  // tile coordinates relative to middle tile:
-  // ------+------+-----
-  // -1,-1 | 0,-1 | 1,-1   z = -1
-  // ------+------+-----
-  // -1,0  | 0,0  | 1,0    z = 0
-  // ------+------+-----
-  // -1,1  | 0,1  | 1,1    z = 1
-  // ------+------+-----
-  // x = -1 x = 0  x = 1
-
-  if (diffX == 0 && diffZ == 0) {
-    return; // we are still in middle tile, nothing to do
+void TileManager::createTiles() {
+  // tiles form a toroidal grid around the tile the camera is in, see
+  // TileGrid
+  grid_ = TileGrid(viewRadius_, std::floor(currentPos_.x / Defaults::TileWidth),
+                   std::floor(currentPos_.z / Defaults::TileWidth));
+  optionsChanged_ = false;
+
+  // generate all tiles in parallel
+  std::vector<std::future<TileData>> jobs(grid_.getSlotCount());
+  std::shared_ptr<const NoiseInterface> noise = noise_;
+  TileStore *store = &store_;
+  TileCache *cache = &cache_;
+  LayerCache *layers = &layers_;
+  for (const TileCoordinates &tile : grid_.getTiles()) {
+    int x = tile.x;
+    int z = tile.z;
+    jobs[grid_.slot(x, z)] =
+        pool_.submit([x, z, noise, store, cache, layers]() {
+          return TileGenerator::generate(x, z, noise, Defaults::TileWidth,
+                                         store, cache, layers);
+        });
   }
 
-  // Moving -Z or North
-  if (diffZ < 0) {
-    // Move first two rows down
-    // 0 1 2      6 7 8
-    // 3 4 5  ->  0 1 2
-    // 6 7 8      3 4 5
-    std::rotate(tiles_.begin(), tiles_.begin() + 6, tiles_.end());
+  if (heightmapMode_) {
+    // each tile gets a layer of the heightmap texture array
+    heightmapPool_.create(jobs.size(), Defaults::TileWidth + 1);
+  } else {
+    // terrain and sea of each tile get a slot of the vertex buffer
+    vertexPool_.create(2 * jobs.size(),
+                       Tile::getSlotSize(Defaults::TileWidth));
+    renderer_.setVertexBuffer(vertexPool_.getBuffer());
+  }
 
-    // Update first row
-    tiles_[0]->updateCoordinates(currentTileX - 1, currentTileZ - 1);
-    tiles_[1]->updateCoordinates(currentTileX, currentTileZ - 1);
-    tiles_[2]->updateCoordinates(currentTileX + 1, currentTileZ - 1);
+  tiles_.clear();
+  for (auto &job : jobs) {
+    TileData data = job.get();
+    std::unique_ptr<Tile> tile(new Tile(data, noise_));
+    tile->setStore(&store_);
+    tile->setCache(&cache_);
+    tile->setLayerCache(&layers_);
+    if (heightmapMode_) {
+      tile->setup(heightmapPool_);
+    } else {
+      tile->setup(vertexPool_);
+    }
+    tile->setSeaLevel(seaLevel_);
+    tile->setShowSea(showSea_);
+    tiles_.push_back(std::move(tile));
   }
+}
 
-  // Moving Z or South
-  if (diffZ > 0) {
-    // Move last two rows up
-    // 0 1 2      3 4 5
-    // 3 4 5  ->  6 7 8
-    // 6 7 8      0 1 2
-    std::rotate(tiles_.begin(), tiles_.begin() + 3, tiles_.end());
+void TileManager::update(glm::vec3 const &currentPos) {
+  ScopedTimer timer("TileManager::update");
 
-    // Update last row
-    tiles_[6]->updateCoordinates(currentTileX - 1, currentTileZ + 1);
-    tiles_[7]->updateCoordinates(currentTileX, currentTileZ + 1);
-    tiles_[8]->updateCoordinates(currentTileX + 1, currentTileZ + 1);
+  // upload tiles whose generation finished since last frame
+  bool previewsPending = false;
+  for (size_t idx = 0; idx < tiles_.size(); idx++) {
+    if (tiles_[idx]->applyFinishedJob()) {
+      appliedTiles_++;
+    }
+    previewsPending |= tiles_[idx]->hasPendingPreview();
   }
 
-  // Moving -X or West
-  if (diffX < 0) {
-    // Move first two columns right
-    // 0 1 2      2 0 1
-    // 3 4 5  ->  5 3 4
-    // 6 7 8      8 6 7
-    std::rotate(tiles_.begin(), tiles_.begin() + 2, tiles_.begin() + 3);
-    std::rotate(tiles_.begin() + 3, tiles_.begin() + 5, tiles_.begin() + 6);
-    std::rotate(tiles_.begin() + 6, tiles_.begin() + 8, tiles_.end());
+  // changes of options while previews of a previous change are still being
+  // generated are coalesced, only the latest options are requested
+  if (optionsChanged_ && !previewsPending) {
+    requestOptions();
+  }
+
+  currentPos_ = currentPos;
+  updateLod(currentPos_);
 
-    // Update first column
-    tiles_[0]->updateCoordinates(currentTileX - 1, currentTileZ - 1);
-    tiles_[3]->updateCoordinates(currentTileX - 1, currentTileZ);
-    tiles_[6]->updateCoordinates(currentTileX - 1, currentTileZ + 1);
+  int newCenterX = std::floor(currentPos_.x / Defaults::TileWidth);
+  int newCenterZ = std::floor(currentPos_.z / Defaults::TileWidth);
+
+  if (newCenterX == grid_.getCenterX() && newCenterZ == grid_.getCenterZ()) {
+    return; // we are still in middle tile, nothing to do
   }
 
-  // Moving X or East
-  if (diffX > 0) {
-    // Move last two columns left
-    // 0 1 2      1 2 0
-    // 3 4 5  ->  4 5 3
-    // 6 7 8      7 8 6
-    std::rotate(tiles_.begin(), tiles_.begin() + 1, tiles_.begin() + 3);
-    std::rotate(tiles_.begin() + 3, tiles_.begin() + 4, tiles_.begin() + 6);
-    std::rotate(tiles_.begin() + 6, tiles_.begin() + 7, tiles_.end());
+  // request all tiles inside of new grid but outside of old grid
+  for (const TileCoordinates &tile : grid_.moveTo(newCenterX, newCenterZ)) {
+    tiles_[grid_.slot(tile.x, tile.z)]->requestCoordinates(tile.x, tile.z,
+                                                            pool_);
+    requestedTiles_++;
+  }
+}
 
-    // Update last column
-    tiles_[2]->updateCoordinates(currentTileX + 1, currentTileZ - 1);
-    tiles_[5]->updateCoordinates(currentTileX + 1, currentTileZ);
-    tiles_[8]->updateCoordinates(currentTileX + 1, currentTileZ + 1);
+void TileManager::updateLod(const glm::vec3 &position) {
+  triangleCount_ = 0;
+  for (size_t idx = 0; idx < tiles_.size(); idx++) {
+    int lod = Defaults::MaximumLod;
+    if (lodEnabled_) {
+      lod = Tile::selectLod(tiles_[idx]->distanceTo(position));
+    }
+    tiles_[idx]->setLod(lod);
+    triangleCount_ += tiles_[idx]->getTriangleCount();
   }
 }
 
 void TileManager::renderAll(const GLfloat &deltaTime,
                             const glm::mat4 &viewMatrix) {
-  // Update and render tiles
+  ScopedTimer timer("TileManager::renderAll");
+
+  // uniforms are updated once for all tiles
+  renderer_.beginFrame(deltaTime, viewMatrix);
+
+  // default frustum contains everything
+  Frustum frustum;
+  if (cullingEnabled_) {
+    frustum = Frustum(renderer_.getViewProjection());
+  }
+  visibleTiles_ = 0;
+  visiblePatches_ = 0;
+
+  if (heightmapMode_) {
+    // instances are culled per tile only
+    instanceBatch_.clear();
+    for (size_t idx = 0; idx < tiles_.size(); idx++) {
+      if (tiles_[idx]->isVisible(frustum)) {
+        tiles_[idx]->addToBatch(instanceBatch_);
+        visibleTiles_++;
+      }
+    }
+    visiblePatches_ = visibleTiles_ * Tile::getPatchCount();
+    renderer_.renderHeightmaps(instanceBatch_, heightmapPool_, showSea_,
+                               seaLevel_);
+    drawCalls_ = instanceBatch_.getGroupCount() * (showSea_ ? 2 : 1);
+    return;
+  }
+
+  if (!batched_) {
+    // two draw calls per visible tile
+    for (size_t idx = 0; idx < tiles_.size(); idx++) {
+      if (tiles_[idx]->isVisible(frustum)) {
+        tiles_[idx]->render();
+        visibleTiles_++;
+      }
+    }
+    visiblePatches_ = visibleTiles_ * Tile::getPatchCount();
+    drawCalls_ = visibleTiles_ * (showSea_ ? 2 : 1);
+    return;
+  }
+
+  // draw calls stay the same no matter how many tiles there are
+  terrainBatch_.clear();
+  seaBatch_.clear();
   for (size_t idx = 0; idx < tiles_.size(); idx++) {
-    // right now, this just updates the light
-    tiles_[idx]->update(deltaTime);
-    tiles_[idx]->render(viewMatrix);
+    GLuint patches =
+        tiles_[idx]->addToBatch(terrainBatch_, seaBatch_, frustum);
+    if (patches > 0) {
+      visibleTiles_++;
+      visiblePatches_ += patches;
+    }
   }
+  renderer_.renderBatches(terrainBatch_, seaBatch_);
+  drawCalls_ = (terrainBatch_.size() > 0 ? 1 : 0) +
+               (seaBatch_.size() > 0 ? 1 : 0);
 }
 
 void TileManager::cleanUp() {
+  destroyTiles();
+  store_.close();
+  instanceBatch_.cleanup();
+  renderer_.cleanup();
+  IndexBuffer::cleanup();
+}
+
+void TileManager::destroyTiles() {
   // Clean up tiles
   for (size_t idx = 0; idx < tiles_.size(); idx++) {
+    tiles_[idx]->waitForPendingJob();
     tiles_[idx]->cleanup();
   }
+  tiles_.clear();
+  vertexPool_.cleanup();
+  heightmapPool_.cleanup();
 }
 
 void TileManager::setTileAlgorithm(const int &algorithm) {
@@ -163,6 +239,8 @@ void TileManager::setTileAlgorithm(const int &algorithm) {
     return;
   }
   currentAlgorithm_ = algorithm;
+  // tiles of new algorithm are requested right away
+  optionsChanged_ = false;
 
   // try to use exisiting noise instance from noiseCache, otherwise create and
   // add new one
@@ -171,31 +249,16 @@ void TileManager::setTileAlgorithm(const int &algorithm) {
     // use already existing noise from cache
     noise_ = result->second;
   } else {
-    // create new noise
-    switch (algorithm) {
-    case Defaults::Perlin:
-      noise_ = std::shared_ptr<NoiseInterface>(new PerlinNoise);
-      break;
-    case Defaults::RidgedMulti:
-      noise_ = std::shared_ptr<NoiseInterface>(new RidgedMultiNoise);
-      break;
-    case Defaults::Billow:
-      noise_ = std::shared_ptr<NoiseInterface>(new BillowNoise);
-      break;
-    case Defaults::Random:
-      noise_ = std::shared_ptr<NoiseInterface>(new RandomNoise);
-      break;
-    default:
-      std::cerr << "Error: unknown algorithm " << algorithm << std::endl;
-    }
-    // and add to cache
+    // create new noise and add to cache
+    noise_ = NoiseInterface::create(algorithm);
     noiseCache_[algorithm] = noise_;
   }
 
   // update tiles
   for (size_t idx = 0; idx < tiles_.size(); idx++) {
-    tiles_[idx]->changeAlgorithm(noise_);
+    tiles_[idx]->requestAlgorithm(noise_, pool_);
   }
+  requestedTiles_ += tiles_.size();
 }
 
 NoiseOptions TileManager::getOptions() {
@@ -203,11 +266,150 @@ NoiseOptions TileManager::getOptions() {
 }
 
 void TileManager::setTileAlgorithmOptions(const NoiseOptions &options) {
-  noise_->setOptions(options);
-  // update tiles
+  // running jobs keep the previous generator, new jobs get a new one. Sliders
+  // change options every frame while dragged, so tiles are only requested in
+  // update()
+  noise_ = noise_->withOptions(options);
+  noiseCache_[currentAlgorithm_] = noise_;
+  optionsChanged_ = true;
+}
+
+void TileManager::requestOptions() {
+  optionsChanged_ = false;
+
+  // jobs run in order of submission. Cheap previews of all tiles come first,
+  // so the whole view shows new options quickly. Jobs of previous options
+  // are skipped if they haven't started yet
   for (size_t idx = 0; idx < tiles_.size(); idx++) {
-    tiles_[idx]->changeAlgorithm(noise_);
+    tiles_[idx]->requestPreview(noise_, pool_);
+  }
+  for (size_t idx = 0; idx < tiles_.size(); idx++) {
+    tiles_[idx]->requestAlgorithm(noise_, pool_);
+  }
+  requestedTiles_ += 2 * tiles_.size();
+}
+
+bool TileManager::getLodEnabled() {
+  return lodEnabled_;
+}
+
+void TileManager::setLodEnabled(bool lodEnabled) {
+  lodEnabled_ = lodEnabled;
+}
+
+size_t TileManager::getTriangleCount() {
+  return triangleCount_;
+}
+
+bool TileManager::getBatched() {
+  return batched_;
+}
+
+void TileManager::setBatched(bool batched) {
+  batched_ = batched;
+}
+
+size_t TileManager::getDrawCalls() {
+  return drawCalls_;
+}
+
+bool TileManager::getCullingEnabled() {
+  return cullingEnabled_;
+}
+
+void TileManager::setCullingEnabled(bool cullingEnabled) {
+  cullingEnabled_ = cullingEnabled;
+}
+
+size_t TileManager::getVisibleTiles() {
+  return visibleTiles_;
+}
+
+size_t TileManager::getCulledTiles() {
+  return tiles_.size() - visibleTiles_;
+}
+
+size_t TileManager::getVisiblePatches() {
+  return visiblePatches_;
+}
+
+size_t TileManager::getCulledPatches() {
+  return tiles_.size() * Tile::getPatchCount() - visiblePatches_;
+}
+
+bool TileManager::getHeightmapMode() {
+  return heightmapMode_;
+}
+
+void TileManager::setHeightmapMode(bool heightmapMode) {
+  if (heightmapMode == heightmapMode_) {
+    return;
   }
+  heightmapMode_ = heightmapMode;
+
+  // tiles have to be set up again with other kind of storage
+  destroyTiles();
+  createTiles();
+}
+
+bool TileManager::getStoreEnabled() {
+  return store_.isOpen();
+}
+
+size_t TileManager::getStoreHits() {
+  return store_.getHits();
+}
+
+size_t TileManager::getStoreMisses() {
+  return store_.getMisses();
+}
+
+size_t TileManager::getStoreBytes() {
+  return store_.getBytes();
+}
+
+size_t TileManager::getCacheHits() {
+  return cache_.getHits();
+}
+
+size_t TileManager::getCacheMisses() {
+  return cache_.getMisses();
+}
+
+size_t TileManager::getCacheSize() {
+  return cache_.getSize();
+}
+
+size_t TileManager::getCacheBytes() {
+  return cache_.getBytes();
+}
+
+bool TileManager::getLayersEnabled() {
+  return layers_.getMaximumBytes() > 0;
+}
+
+void TileManager::setLayersEnabled(bool layersEnabled) {
+  // running jobs may still add layers of a few tiles
+  layers_.setMaximumBytes(layersEnabled ? Defaults::LayerCacheBytes : 0);
+}
+
+size_t TileManager::getLayerBytes() {
+  return layers_.getBytes();
+}
+
+int TileManager::getViewRadius() {
+  return viewRadius_;
+}
+
+void TileManager::setViewRadius(const int &viewRadius) {
+  if (viewRadius == viewRadius_ || viewRadius < 0) {
+    return;
+  }
+  viewRadius_ = viewRadius;
+
+  // rebuild grid with new size
+  destroyTiles();
+  createTiles();
 }
 
 bool TileManager::getShowSea() {
@@ -231,3 +433,11 @@ void TileManager::setSeaLevel(const float &seaLevel) {
     tiles_[idx]->setSeaLevel(seaLevel_);
   }
 }
+
+size_t TileManager::getRequestedTiles() {
+  return requestedTiles_;
+}
+
+size_t TileManager::getAppliedTiles() {
+  return appliedTiles_;
+}
@@ -0,0 +1,493 @@
+/*
+ * Copyright (C) 2016 sgelb
+ *
+ * This file is part of litlanes.
+ *
+ * litlanes is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * litlanes is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with litlanes.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "tileStore.h"
+
+// "LLTS", first bytes of every tile file
+static const uint32_t Magic = 0x53544c4c;
+// increase when layout of tile files changes, old files are ignored then
+static const uint32_t Version = 1;
+static const uint16_t MaximumValue = 0xffff;
+
+// tile file is a header followed by count 16 bit heights
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  int32_t algorithm;
+  NoiseOptions options;
+  int32_t x;
+  int32_t z;
+  uint32_t count;
+  float minimum;
+  float scale;
+};
+
+static bool operator==(const NoiseOptions &a, const NoiseOptions &b) {
+  return a.frequency == b.frequency && a.lacunarity == b.lacunarity &&
+         a.octaveCount == b.octaveCount && a.persistence == b.persistence &&
+         a.seed == b.seed;
+}
+
+static uint64_t hashBytes(uint64_t hash, const void *data, const size_t &size) {
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+TileKey::TileKey(const NoiseInterface &noise, const int &x, const int &z)
+    : algorithm(noise.getAlgorithm()),
+      options(noise.getOptions()),
+      x(x),
+      z(z) {
+}
+
+uint64_t TileKey::hash() const {
+  // fields one by one, so padding never ends up in the hash
+  uint64_t hash = 0xcbf29ce484222325ull;
+  hash = hashBytes(hash, &algorithm, sizeof(algorithm));
+  hash = hashBytes(hash, &options.frequency, sizeof(options.frequency));
+  hash = hashBytes(hash, &options.lacunarity, sizeof(options.lacunarity));
+  hash = hashBytes(hash, &options.octaveCount, sizeof(options.octaveCount));
+  hash = hashBytes(hash, &options.persistence, sizeof(options.persistence));
+  hash = hashBytes(hash, &options.seed, sizeof(options.seed));
+  hash = hashBytes(hash, &x, sizeof(x));
+  return hashBytes(hash, &z, sizeof(z));
+}
+
+bool TileKey::operator==(const TileKey &other) const {
+  return algorithm == other.algorithm && options == other.options &&
+         x == other.x && z == other.z;
+}
+
+// copy heights of tile file in data into heights, if it holds count heights
+// of key. Different keys may share a hash, so the whole key is compared
+static bool parseTile(const char *data, const size_t &size,
+                      const TileKey &key, const size_t &count,
+                      std::vector<float> &heights) {
+  FileHeader header;
+  if (size != sizeof(header) + count * sizeof(uint16_t)) {
+    return false;
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != Magic || header.version != Version ||
+      header.algorithm != key.algorithm || !(header.options == key.options) ||
+      header.x != key.x || header.z != key.z || header.count != count) {
+    return false;
+  }
+  std::vector<uint16_t> values(count);
+  std::memcpy(&values.front(), data + sizeof(header),
+              count * sizeof(uint16_t));
+  TileStore::dequantize(&values.front(), count, header.minimum, header.scale,
+                        heights);
+  return true;
+}
+
+// read tile file at path. Files are mapped instead of read where possible
+static bool readTile(const std::string &path, const TileKey &key,
+                     const size_t &count, std::vector<float> &heights,
+                     size_t &bytes) {
+#ifdef _WIN32
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+  bytes = data.size();
+  return !data.empty() &&
+         parseTile(&data.front(), data.size(), key, count, heights);
+#else
+  int file = ::open(path.c_str(), O_RDONLY);
+  if (file < 0) {
+    return false;
+  }
+  struct stat status;
+  if (fstat(file, &status) != 0 || status.st_size == 0) {
+    ::close(file);
+    return false;
+  }
+  bytes = status.st_size;
+  void *data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, file, 0);
+  ::close(file);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  bool found =
+      parseTile(static_cast<const char *>(data), bytes, key, count, heights);
+  munmap(data, bytes);
+  return found;
+#endif
+}
+
+// names and sizes of regular files in directory
+static std::map<std::string, size_t> listFiles(const std::string &directory) {
+  std::map<std::string, size_t> files;
+#ifdef _WIN32
+  _finddata_t file;
+  intptr_t handle = _findfirst((directory + "/*").c_str(), &file);
+  if (handle == -1) {
+    return files;
+  }
+  do {
+    if (!(file.attrib & _A_SUBDIR)) {
+      files[file.name] = file.size;
+    }
+  } while (_findnext(handle, &file) == 0);
+  _findclose(handle);
+#else
+  DIR *handle = opendir(directory.c_str());
+  if (handle == nullptr) {
+    return files;
+  }
+  while (dirent *entry = readdir(handle)) {
+    struct stat status;
+    std::string path = directory + "/" + entry->d_name;
+    if (stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode)) {
+      files[entry->d_name] = status.st_size;
+    }
+  }
+  closedir(handle);
+#endif
+  return files;
+}
+
+TileStore::TileStore()
+    : maximumBytes_(0),
+      open_(false),
+      bytes_(0),
+      hits_(0),
+      misses_(0),
+      temporaryCount_(0) {
+}
+
+TileStore::~TileStore() {
+  close();
+}
+
+bool TileStore::open(const std::string &directory,
+                     const size_t &maximumBytes) {
+  close();
+
+#ifdef _WIN32
+  int result = _mkdir(directory.c_str());
+#else
+  int result = mkdir(directory.c_str(), 0755);
+#endif
+  if (result != 0 && errno != EEXIST) {
+    std::cerr << "Error: can't create tile store " << directory << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  directory_ = directory;
+  maximumBytes_ = maximumBytes;
+  open_ = true;
+  readIndex();
+  scanDirectory();
+  evict();
+  return true;
+}
+
+void TileStore::close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!open_) {
+    return;
+  }
+  writeIndex();
+  open_ = false;
+  usage_.clear();
+  entries_.clear();
+  bytes_ = 0;
+}
+
+bool TileStore::isOpen() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return open_;
+}
+
+bool TileStore::load(const TileKey &key, const size_t &count,
+                     std::vector<float> &heights) {
+  std::string path;
+  uint64_t hash = key.hash();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) {
+      return false;
+    }
+    path = getPath(hash);
+  }
+
+  // files are replaced by renaming and removed by unlinking, so reading
+  // without lock is safe: a mapped file stays valid until it is unmapped
+  size_t bytes = 0;
+  bool found = readTile(path, key, count, heights, bytes);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!found) {
+    misses_++;
+    // tile of index removed by hand or by eviction in another process.
+    // Saves rename under lock, so a missing file is really gone
+    if (open_ && entries_.count(hash) > 0 && !std::ifstream(path)) {
+      remove(hash);
+    }
+    return false;
+  }
+  hits_++;
+  // tiles saved by other processes since open() are picked up here
+  touch(hash, bytes);
+  return true;
+}
+
+void TileStore::save(const TileKey &key, const std::vector<float> &heights) {
+  FileHeader header;
+  header.magic = Magic;
+  header.version = Version;
+  header.algorithm = key.algorithm;
+  header.options = key.options;
+  header.x = key.x;
+  header.z = key.z;
+  header.count = heights.size();
+  std::vector<uint16_t> values;
+  quantize(heights, header.minimum, header.scale, values);
+
+  uint64_t hash = key.hash();
+  std::string path;
+  std::string temporary;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) {
+      return;
+    }
+    path = getPath(hash);
+    // jobs may save the same tile at once, each writes its own file
+    temporary = path + "." + std::to_string(temporaryCount_++) + ".tmp";
+  }
+
+  // file is written without lock, so jobs saving tiles don't wait for each
+  // other's disk writes. Readers only ever see complete tiles, as the
+  // temporary file is renamed once it is complete
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(&values.front()),
+               values.size() * sizeof(uint16_t));
+    if (!file) {
+      std::cerr << "Error: can't write tile " << temporary << std::endl;
+      std::remove(temporary.c_str());
+      return;
+    }
+  }
+  // renamed under lock, so evict() can't remove the new file between rename
+  // and touch()
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!open_) {
+    std::remove(temporary.c_str());
+    return;
+  }
+#ifdef _WIN32
+  // rename doesn't replace existing files on windows
+  std::remove(path.c_str());
+#endif
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    return;
+  }
+  touch(hash, sizeof(header) + values.size() * sizeof(uint16_t));
+  evict();
+}
+
+void TileStore::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!usage_.empty()) {
+    remove(usage_.back());
+  }
+  std::remove(getIndexPath().c_str());
+}
+
+size_t TileStore::getBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+size_t TileStore::getTileCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+size_t TileStore::getHits() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+size_t TileStore::getMisses() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+void TileStore::quantize(const std::vector<float> &heights, float &minimum,
+                         float &scale, std::vector<uint16_t> &values) {
+  // range of each tile is spread over all 16 bit values
+  auto range = std::minmax_element(heights.begin(), heights.end());
+  minimum = *range.first;
+  scale = (*range.second - minimum) / MaximumValue;
+
+  values.resize(heights.size());
+  for (size_t i = 0; i < heights.size(); i++) {
+    values[i] = scale > 0.0f ? std::lround((heights[i] - minimum) / scale) : 0;
+  }
+}
+
+void TileStore::dequantize(const uint16_t *values, const size_t &count,
+                           const float &minimum, const float &scale,
+                           std::vector<float> &heights) {
+  heights.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    heights[i] = minimum + values[i] * scale;
+  }
+}
+
+std::string TileStore::getPath(const uint64_t &hash) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.tile",
+                static_cast<unsigned long long>(hash));
+  return directory_ + "/" + name;
+}
+
+std::string TileStore::getIndexPath() {
+  return directory_ + "/index";
+}
+
+void TileStore::readIndex() {
+  // one line "hash bytes" per tile, most recently used first
+  std::ifstream file(getIndexPath());
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    unsigned long long hash = 0;
+    size_t bytes = 0;
+    if (!(fields >> std::hex >> hash >> std::dec >> bytes) ||
+        entries_.count(hash) > 0) {
+      continue;
+    }
+    usage_.push_back(hash);
+    entries_[hash] = Entry{bytes, std::prev(usage_.end())};
+    bytes_ += bytes;
+  }
+}
+
+void TileStore::scanDirectory() {
+  // index is only written by close(), so it misses tiles of sessions that
+  // crashed or were killed, and temporary files of interrupted saves
+  std::map<std::string, size_t> files = listFiles(directory_);
+  std::set<uint64_t> found;
+  for (auto &file : files) {
+    const std::string &name = file.first;
+    unsigned long long hash = 0;
+    char rest[8];
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+      std::remove((directory_ + "/" + name).c_str());
+    } else if (name.size() == 21 &&
+               std::sscanf(name.c_str(), "%16llx.%4s", &hash, rest) == 2 &&
+               std::strcmp(rest, "tile") == 0) {
+      found.insert(hash);
+      if (entries_.count(hash) == 0) {
+        // unknown tiles are used least recently
+        usage_.push_back(hash);
+        entries_[hash] = Entry{file.second, std::prev(usage_.end())};
+        bytes_ += file.second;
+      }
+    }
+  }
+
+  // tiles of index whose files are gone
+  for (auto entry = entries_.begin(); entry != entries_.end();) {
+    auto next = std::next(entry);
+    if (found.count(entry->first) == 0) {
+      bytes_ -= entry->second.bytes;
+      usage_.erase(entry->second.position);
+      entries_.erase(entry);
+    }
+    entry = next;
+  }
+}
+
+void TileStore::writeIndex() {
+  std::ofstream file(getIndexPath(), std::ios::trunc);
+  for (uint64_t hash : usage_) {
+    file << std::hex << hash << " " << std::dec << entries_[hash].bytes
+         << "\n";
+  }
+  if (!file) {
+    std::cerr << "Error: can't write tile store index" << std::endl;
+  }
+}
+
+void TileStore::touch(const uint64_t &hash, const size_t &bytes) {
+  auto entry = entries_.find(hash);
+  if (entry == entries_.end()) {
+    usage_.push_front(hash);
+    entries_[hash] = Entry{bytes, usage_.begin()};
+    bytes_ += bytes;
+    return;
+  }
+  usage_.splice(usage_.begin(), usage_, entry->second.position);
+  bytes_ = bytes_ - entry->second.bytes + bytes;
+  entry->second.bytes = bytes;
+}
+
+void TileStore::remove(const uint64_t &hash) {
+  auto entry = entries_.find(hash);
+  if (entry == entries_.end()) {
+    return;
+  }
+  std::remove(getPath(hash).c_str());
+  bytes_ -= entry->second.bytes;
+  usage_.erase(entry->second.position);
+  entries_.erase(entry);
+}
+
+void TileStore::evict() {
+  while (bytes_ > maximumBytes_ && !usage_.empty()) {
+    remove(usage_.back());
+  }
+}
@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+#include <arguments.h>
+#include <string>
+
+TEST(ArgumentsTest, valueOfNamedArgument) {
+  EXPECT_EQ(std::string("4"), Arguments::getValue("--octaves=4", "--octaves"));
+  EXPECT_EQ(std::string(""), Arguments::getValue("--octaves=", "--octaves"));
+  EXPECT_EQ(nullptr, Arguments::getValue("--octaves", "--octaves"));
+  EXPECT_EQ(nullptr, Arguments::getValue("--octavesx=4", "--octaves"));
+  EXPECT_EQ(nullptr, Arguments::getValue("--seed=4", "--octaves"));
+}
+
+TEST(ArgumentsTest, parsesWholeText) {
+  long integer = 0;
+  EXPECT_TRUE(Arguments::parseInteger("-12", integer));
+  EXPECT_EQ(-12, integer);
+  EXPECT_FALSE(Arguments::parseInteger("", integer));
+  EXPECT_FALSE(Arguments::parseInteger("3x", integer));
+  EXPECT_FALSE(Arguments::parseInteger("2.5", integer));
+  EXPECT_FALSE(Arguments::parseInteger("99999999999999999999", integer));
+
+  double number = 0.0;
+  EXPECT_TRUE(Arguments::parseNumber("0.25", number));
+  EXPECT_DOUBLE_EQ(0.25, number);
+  EXPECT_TRUE(Arguments::parseNumber("1e-3", number));
+  EXPECT_FALSE(Arguments::parseNumber("abc", number));
+  EXPECT_FALSE(Arguments::parseNumber("1.5s", number));
+}
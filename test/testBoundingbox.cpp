@@ -42,3 +42,11 @@ TEST(BoundingboxTest, sphereShouldIntersectIfBoxInside) {
   float radius = 3.0f;
   EXPECT_TRUE(bb.intersectsWithSphere(sphere, radius));
 }
+
+TEST(BoundingboxTest, boxFromCorners) {
+  BoundingBox bb(glm::vec3(0.0f, 1.0f, 2.0f), glm::vec3(3.0f, 4.0f, 5.0f));
+  EXPECT_EQ(glm::vec3(0.0f, 1.0f, 2.0f), bb.getMinimum());
+  EXPECT_EQ(glm::vec3(3.0f, 4.0f, 5.0f), bb.getMaximum());
+  EXPECT_TRUE(bb.intersectsWithSphere(glm::vec3(4.0f, 2.0f, 3.0f), 1.0f));
+  EXPECT_FALSE(bb.intersectsWithSphere(glm::vec3(5.0f, 2.0f, 3.0f), 1.0f));
+}
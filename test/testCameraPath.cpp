@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <cameraPath.h>
+#include <sstream>
+#include <string>
+
+static const char Path[] = "# fly east\n"
+                           "0 camera 0 10 0 -90 -30\n"
+                           "\n"
+                           "4.0 algorithm ridgedmulti  # switch\n"
+                           "2 camera 64 20 -32 -45 -10\n"
+                           "5 octaves 3\n"
+                           "5 seed 7\n";
+
+static bool parse(CameraPath &path, const std::string &text) {
+  std::istringstream input(text);
+  return path.parse(input);
+}
+
+TEST(CameraPathTest, interpolatesPoses) {
+  CameraPath path;
+  ASSERT_TRUE(parse(path, Path));
+  EXPECT_DOUBLE_EQ(5.0, path.getDuration());
+
+  CameraPath::Pose pose = path.getPose(0.5);
+  EXPECT_FLOAT_EQ(16.0f, pose.position.x);
+  EXPECT_FLOAT_EQ(12.5f, pose.position.y);
+  EXPECT_FLOAT_EQ(-8.0f, pose.position.z);
+  EXPECT_FLOAT_EQ(-78.75f, pose.yaw);
+  EXPECT_FLOAT_EQ(-25.0f, pose.pitch);
+
+  // first and last pose before and after path
+  EXPECT_FLOAT_EQ(0.0f, path.getPose(-1.0).position.x);
+  EXPECT_FLOAT_EQ(64.0f, path.getPose(3.0).position.x);
+}
+
+TEST(CameraPathTest, changesInTimeRange) {
+  CameraPath path;
+  ASSERT_TRUE(parse(path, Path));
+  EXPECT_TRUE(path.getChanges(0.0, 4.0).empty());
+
+  std::vector<CameraPath::Change> changes = path.getChanges(4.0, 5.0);
+  ASSERT_EQ(1u, changes.size());
+  EXPECT_EQ("algorithm", changes[0].name);
+  EXPECT_EQ(Defaults::RidgedMulti, static_cast<int>(changes[0].value));
+
+  NoiseOptions options = NoiseInterface::create(Defaults::Perlin)->getOptions();
+  changes = path.getChanges(5.0, 6.0);
+  ASSERT_EQ(2u, changes.size());
+  EXPECT_FALSE(CameraPath::applyOption(path.getChanges(4.0, 5.0)[0], options));
+  EXPECT_TRUE(CameraPath::applyOption(changes[0], options));
+  EXPECT_TRUE(CameraPath::applyOption(changes[1], options));
+  EXPECT_EQ(3, options.octaveCount);
+  EXPECT_EQ(7, options.seed);
+}
+
+TEST(CameraPathTest, rejectsInvalidCommands) {
+  CameraPath path;
+  EXPECT_FALSE(parse(path, "0 camera 1 2 3 4\n"));
+  EXPECT_FALSE(parse(path, "0 camera 1 2 3 4 5 6\n"));
+  EXPECT_FALSE(parse(path, "0 camera 1 2 3 4 5\n1 algorithm fractal\n"));
+  EXPECT_FALSE(parse(path, "0 camera 1 2 3 4 5\n1 zoom 2\n"));
+  EXPECT_FALSE(parse(path, "camera 1 2 3 4 5\n"));
+  // options out of range, libnoise would throw on octaves
+  EXPECT_FALSE(parse(path, "0 camera 1 2 3 4 5\n17 octaves 0\n"));
+  EXPECT_FALSE(parse(path, "0 camera 1 2 3 4 5\n1 octaves 40\n"));
+  EXPECT_FALSE(parse(path, "0 camera 1 2 3 4 5\n1 seed 2.5\n"));
+  EXPECT_FALSE(parse(path, "0 camera 1 2 3 4 5\n1 frequency -1\n"));
+  EXPECT_TRUE(parse(path, "0 camera 1 2 3 4 5\n1 octaves 30\n"));
+  // no pose
+  EXPECT_FALSE(parse(path, "1 seed 3\n"));
+  EXPECT_FALSE(path.load("testCameraPathMissing.path"));
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <frameReport.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static const char ReportPath[] = "testFrameReport.csv";
+
+TEST(FrameReportTest, writesRowPerFrame) {
+  Profiler profiler;
+  profiler.setEnabled(true);
+  FrameReport report;
+  report.addSetting("tile store", "off");
+
+  profiler.record("update", 0.0, 2000.0);
+  profiler.endFrame();
+  report.addFrame(0.0, 16.0f, 9, 0, profiler.getStages());
+  // stage appearing later gets a new column
+  profiler.record("update", 0.0, 1000.0);
+  profiler.record("render", 0.0, 500.0);
+  profiler.endFrame();
+  report.addFrame(0.5, 8.0f, 0, 3, profiler.getStages());
+  EXPECT_EQ(2u, report.getFrameCount());
+
+  ASSERT_TRUE(report.write(ReportPath));
+  std::ifstream file(ReportPath);
+  std::string setting, header, first, second;
+  std::getline(file, setting);
+  std::getline(file, header);
+  std::getline(file, first);
+  std::getline(file, second);
+  EXPECT_EQ("# tile store: off", setting);
+  EXPECT_EQ("frame,time,frame_ms,tiles_requested,tiles_applied,"
+            "\"update\",\"render\"",
+            header);
+  EXPECT_EQ("0,0.0000,16.000,9,0,2.000,", first);
+  EXPECT_EQ("1,0.5000,8.000,0,3,1.000,0.500", second);
+  file.close();
+  std::remove(ReportPath);
+
+  std::ostringstream summary;
+  report.writeSummary(summary);
+  EXPECT_EQ("tile store: off\n"
+            "2 frames, ms/frame: mean 12.00, p50 8.00, p95 16.00, p99 16.00, "
+            "max 16.00\n",
+            summary.str());
+}
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "frustum.h"
+
+// camera at origin looking down -z
+static Frustum createFrustum() {
+  glm::mat4 projection = glm::perspective(45.0f, 1.5f, 0.1f, 100.0f);
+  glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+                               glm::vec3(0.0f, 1.0f, 0.0f));
+  return Frustum(projection * view);
+}
+
+TEST(FrustumTest, boxInFrontIsInside) {
+  BoundingBox box(glm::vec3(-1.0f, -1.0f, -11.0f),
+                  glm::vec3(1.0f, 1.0f, -9.0f));
+  EXPECT_EQ(Frustum::Inside, createFrustum().classify(box));
+}
+
+TEST(FrustumTest, boxBehindIsOutside) {
+  BoundingBox box(glm::vec3(-1.0f, -1.0f, 9.0f), glm::vec3(1.0f, 1.0f, 11.0f));
+  EXPECT_EQ(Frustum::Outside, createFrustum().classify(box));
+}
+
+TEST(FrustumTest, boxBeyondFarPlaneIsOutside) {
+  BoundingBox box(glm::vec3(-1.0f, -1.0f, -200.0f),
+                  glm::vec3(1.0f, 1.0f, -150.0f));
+  EXPECT_EQ(Frustum::Outside, createFrustum().classify(box));
+}
+
+TEST(FrustumTest, boxAcrossSidePlaneIntersects) {
+  BoundingBox box(glm::vec3(-100.0f, -1.0f, -11.0f),
+                  glm::vec3(0.0f, 1.0f, -9.0f));
+  EXPECT_EQ(Frustum::Intersects, createFrustum().classify(box));
+}
+
+TEST(FrustumTest, defaultFrustumContainsEverything) {
+  BoundingBox box(glm::vec3(-1e6f), glm::vec3(1e6f));
+  EXPECT_EQ(Frustum::Inside, Frustum().classify(box));
+}
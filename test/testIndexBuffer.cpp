@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <indexBuffer.h>
+#include <quadtree.h>
+#include <defaults.h>
+#include <vector>
+
+TEST(IndexBufferTest, levelsAreStoredBackToBack) {
+  GLuint expected = 0;
+  for (int lod = 0; lod <= Defaults::MaximumLod; lod++) {
+    EXPECT_EQ(expected, IndexBuffer::getOffset(lod)) << "Wrong offset " << lod;
+    expected += IndexBuffer::getCount(lod);
+  }
+  EXPECT_EQ(expected, IndexBuffer::getIndices().size());
+}
+
+TEST(IndexBufferTest, gridIndicesMatchQuadtree) {
+  Quadtree quadtree;
+  for (int lod = 0; lod <= Defaults::MaximumLod; lod++) {
+    std::vector<GLuint> expected = quadtree.getIndicesOfLevel(lod);
+    ASSERT_EQ(expected.size(), IndexBuffer::getGridCount(lod));
+    const GLuint *indices =
+        &IndexBuffer::getIndices()[IndexBuffer::getOffset(lod)];
+    for (size_t i = 0; i < expected.size(); i++) {
+      EXPECT_EQ(expected[i], indices[i]) << "Level " << lod << " index " << i;
+    }
+  }
+}
+
+TEST(IndexBufferTest, skirtIndicesCountOfMaximumLod) {
+  // two triangles for each of the TileWidth segments on all four edges
+  GLuint expected = 4 * 6 * Defaults::TileWidth;
+  GLuint result = IndexBuffer::getCount(Defaults::MaximumLod) -
+                  IndexBuffer::getGridCount(Defaults::MaximumLod);
+  EXPECT_EQ(expected, result);
+}
+
+TEST(IndexBufferTest, skirtIndicesReferenceSkirtVertices) {
+  GLuint width = Defaults::TileWidth + 1;
+  std::vector<GLuint> skirt = IndexBuffer::createSkirtIndices(
+      Defaults::MaximumLod, Defaults::TileWidth);
+  for (GLuint index : skirt) {
+    EXPECT_LT(index, width * width + 4 * width);
+  }
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <layerCache.h>
+#include <memory>
+#include <vector>
+
+static const int Width = Defaults::TileWidth + 1;
+
+static std::vector<float> expectedHeights(const NoiseInterface &noise,
+                                          const int &x, const int &z) {
+  std::vector<float> heights(Width * Width);
+  noise.fillHeights(x * Defaults::TileWidth, z * Defaults::TileWidth, Width,
+                    Width, Width, &heights.front());
+  return heights;
+}
+
+static std::vector<float> layerHeights(LayerCache &cache,
+                                       const NoiseInterface &noise,
+                                       const int &x, const int &z) {
+  std::vector<float> heights(Width * Width);
+  EXPECT_TRUE(cache.fillHeights(noise, x, z, Width, &heights.front()));
+  return heights;
+}
+
+// persistence and octave count changes of noise are weighted from layers
+// and give exactly the same heights as evaluating noise
+static void expectReweighting(const NoiseInterface &noise) {
+  LayerCache cache;
+  EXPECT_EQ(expectedHeights(noise, 1, -2), layerHeights(cache, noise, 1, -2));
+  EXPECT_EQ(0u, cache.getHits());
+  EXPECT_EQ(1u, cache.getMisses());
+
+  NoiseOptions options = noise.getOptions();
+  options.persistence = 0.3f;
+  std::shared_ptr<const NoiseInterface> changed = noise.withOptions(options);
+  EXPECT_EQ(expectedHeights(*changed, 1, -2),
+            layerHeights(cache, *changed, 1, -2));
+  options.octaveCount -= 2;
+  changed = noise.withOptions(options);
+  EXPECT_EQ(expectedHeights(*changed, 1, -2),
+            layerHeights(cache, *changed, 1, -2));
+  EXPECT_EQ(2u, cache.getHits());
+
+  // more octaves generate only the added ones
+  size_t bytes = cache.getBytes();
+  options.octaveCount += 4;
+  changed = noise.withOptions(options);
+  EXPECT_EQ(expectedHeights(*changed, 1, -2),
+            layerHeights(cache, *changed, 1, -2));
+  EXPECT_EQ(2u, cache.getMisses());
+  EXPECT_EQ(bytes / noise.getOptions().octaveCount * options.octaveCount,
+            cache.getBytes());
+}
+
+TEST(LayerCacheTest, perlinIsReweighted) {
+  expectReweighting(PerlinNoise());
+}
+
+TEST(LayerCacheTest, billowIsReweighted) {
+  expectReweighting(BillowNoise());
+}
+
+TEST(LayerCacheTest, otherOptionsMiss) {
+  LayerCache cache;
+  PerlinNoise noise;
+  layerHeights(cache, noise, 0, 0);
+  NoiseOptions options = noise.getOptions();
+  options.lacunarity = 2.5f;
+  PerlinNoise changed(options);
+  EXPECT_EQ(expectedHeights(changed, 0, 0),
+            layerHeights(cache, changed, 0, 0));
+  layerHeights(cache, BillowNoise(), 0, 0);
+  layerHeights(cache, noise, 1, 0);
+  EXPECT_EQ(0u, cache.getHits());
+  EXPECT_EQ(4u, cache.getMisses());
+}
+
+TEST(LayerCacheTest, onlyNoiseWithLayers) {
+  LayerCache cache;
+  std::vector<float> heights(Width * Width);
+  EXPECT_FALSE(
+      cache.fillHeights(RidgedMultiNoise(), 0, 0, Width, &heights.front()));
+  EXPECT_FALSE(cache.fillHeights(RandomNoise(), 0, 0, Width, &heights.front()));
+
+  cache.setMaximumBytes(0);
+  EXPECT_FALSE(cache.fillHeights(PerlinNoise(), 0, 0, Width, &heights.front()));
+}
+
+TEST(LayerCacheTest, dropsLeastRecentlyUsed) {
+  PerlinNoise noise;
+  size_t tileBytes =
+      Width * Width * noise.getOptions().octaveCount * sizeof(double);
+  LayerCache cache(2 * tileBytes);
+  layerHeights(cache, noise, 0, 0);
+  layerHeights(cache, noise, 1, 0);
+  layerHeights(cache, noise, 0, 0);
+  layerHeights(cache, noise, 2, 0);
+  EXPECT_EQ(2 * tileBytes, cache.getBytes());
+
+  // 1, 0 was dropped
+  layerHeights(cache, noise, 0, 0);
+  layerHeights(cache, noise, 1, 0);
+  EXPECT_EQ(2u, cache.getHits());
+  EXPECT_EQ(4u, cache.getMisses());
+}
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include <noise.h>
+#include <limits>
+#include <memory>
+#include <typeinfo>
+#include <vector>
+
+// fillHeights() of a noise has to return the same values as getValue()
+static void expectBatchMatchesScalar(const NoiseInterface &noise,
+                                     const int &xOffset, const int &zOffset,
+                                     const int &columns, const int &rows,
+                                     const int &stride) {
+  std::vector<float> heights(rows * stride, -42.0f);
+  noise.fillHeights(xOffset, zOffset, columns, rows, stride,
+                    &heights.front());
+  for (int row = 0; row < rows; row++) {
+    for (int column = 0; column < columns; column++) {
+      float expected = noise.getValue(xOffset + column, 0.0f, zOffset + row);
+      EXPECT_FLOAT_EQ(expected, heights[row * stride + column])
+          << "Values differ at row " << row << " column " << column;
+    }
+    for (int column = columns; column < stride; column++) {
+      EXPECT_EQ(-42.0f, heights[row * stride + column])
+          << "Padding overwritten at row " << row << " column " << column;
+    }
+  }
+}
+
+static void expectBatchMatchesScalar(const NoiseInterface &noise) {
+  NoiseOptions options = noise.getOptions();
+  expectBatchMatchesScalar(noise, 0, 0, Defaults::TileWidth + 1,
+                           Defaults::TileWidth + 1, Defaults::TileWidth + 1);
+  // negative coordinates, width not a multiple of NoiseKernel::Lanes
+  expectBatchMatchesScalar(noise, -3 * Defaults::TileWidth, -17, 13, 13, 16);
+  // single row and single column
+  expectBatchMatchesScalar(noise, 7, 9, 11, 1, 11);
+  expectBatchMatchesScalar(noise, 7, 9, 1, 11, 3);
+
+  options.frequency *= 3.0f;
+  options.lacunarity = 2.5f;
+  options.octaveCount = 3;
+  options.persistence = 0.7f;
+  options.seed = 4711;
+  std::shared_ptr<const NoiseInterface> changed = noise.withOptions(options);
+  expectBatchMatchesScalar(*changed, 5 * Defaults::TileWidth, -2, 21, 18, 21);
+}
+
+// 2D kernels have to give the same values as the 3D libnoise module at y = 0
+template <typename Module>
+static void expectMatchesLibnoise(const NoiseInterface &noise,
+                                  const Module &module) {
+  // signed bound, Resolution is unsigned
+  const int range = 3 * static_cast<int>(Defaults::Resolution);
+  int samples = 0;
+  for (int z = -range; z < range; z += 7) {
+    for (int x = -range; x < range; x += 5) {
+      float sampleX = static_cast<float>(x) / Defaults::Resolution;
+      float sampleZ = static_cast<float>(z) / Defaults::Resolution;
+      float expected = module.GetValue(sampleX, 0.0, sampleZ);
+      EXPECT_FLOAT_EQ(expected, noise.getValue(x, 0.0f, z))
+          << "Values differ at x " << x << " z " << z;
+      samples++;
+    }
+  }
+  EXPECT_EQ(((2 * range + 6) / 7) * ((2 * range + 4) / 5), samples);
+}
+
+static NoiseOptions changedOptions(NoiseOptions options) {
+  options.frequency *= 2.0f;
+  options.lacunarity = 1.75f;
+  options.octaveCount = 8;
+  options.persistence = 0.4f;
+  options.seed = -12;
+  return options;
+}
+
+TEST(NoiseTest, perlinMatchesLibnoise) {
+  PerlinNoise noise;
+  noise::module::Perlin module;
+  expectMatchesLibnoise(noise, module);
+
+  NoiseOptions options = changedOptions(PerlinNoise::getDefaultOptions());
+  module.SetFrequency(options.frequency);
+  module.SetLacunarity(options.lacunarity);
+  module.SetOctaveCount(options.octaveCount);
+  module.SetPersistence(options.persistence);
+  module.SetSeed(options.seed);
+  expectMatchesLibnoise(PerlinNoise(options), module);
+}
+
+TEST(NoiseTest, ridgedMultiMatchesLibnoise) {
+  RidgedMultiNoise noise;
+  noise::module::RidgedMulti module;
+  expectMatchesLibnoise(noise, module);
+
+  NoiseOptions options = changedOptions(RidgedMultiNoise::getDefaultOptions());
+  module.SetFrequency(options.frequency);
+  module.SetLacunarity(options.lacunarity);
+  module.SetOctaveCount(options.octaveCount);
+  module.SetSeed(options.seed);
+  expectMatchesLibnoise(RidgedMultiNoise(options), module);
+}
+
+TEST(NoiseTest, billowMatchesLibnoise) {
+  BillowNoise noise;
+  noise::module::Billow module;
+  expectMatchesLibnoise(noise, module);
+
+  NoiseOptions options = changedOptions(BillowNoise::getDefaultOptions());
+  module.SetFrequency(options.frequency);
+  module.SetLacunarity(options.lacunarity);
+  module.SetOctaveCount(options.octaveCount);
+  module.SetPersistence(options.persistence);
+  module.SetSeed(options.seed);
+  expectMatchesLibnoise(BillowNoise(options), module);
+}
+
+TEST(NoiseTest, perlinBatchMatchesScalar) {
+  PerlinNoise noise;
+  expectBatchMatchesScalar(noise);
+}
+
+TEST(NoiseTest, ridgedMultiBatchMatchesScalar) {
+  RidgedMultiNoise noise;
+  expectBatchMatchesScalar(noise);
+}
+
+TEST(NoiseTest, billowBatchMatchesScalar) {
+  BillowNoise noise;
+  expectBatchMatchesScalar(noise);
+}
+
+TEST(NoiseTest, randomBatchMatchesScalar) {
+  RandomNoise noise;
+  expectBatchMatchesScalar(noise);
+}
+
+TEST(NoiseTest, mountainsBatchMatchesScalar) {
+  MountainNoise noise;
+  expectBatchMatchesScalar(noise);
+}
+
+TEST(NoiseTest, randomBatchFillsRange) {
+  RandomNoise noise;
+  int width = Defaults::TileWidth + 1;
+  std::vector<float> heights(width * width, -1.0f);
+  noise.fillHeights(0, 0, width, width, width, &heights.front());
+  for (float height : heights) {
+    EXPECT_GE(height, 0.0f);
+    EXPECT_LE(height, 1.0f);
+  }
+}
+
+TEST(NoiseTest, withOptionsLeavesGeneratorUnchanged) {
+  std::shared_ptr<const NoiseInterface> noise(new PerlinNoise);
+  float expected = noise->getValue(17.0f, 0.0f, -5.0f);
+
+  NoiseOptions options = noise->getOptions();
+  options.seed++;
+  std::shared_ptr<const NoiseInterface> changed = noise->withOptions(options);
+
+  EXPECT_EQ(options.seed, changed->getOptions().seed);
+  EXPECT_EQ(options.seed - 1, noise->getOptions().seed);
+  EXPECT_EQ(expected, noise->getValue(17.0f, 0.0f, -5.0f));
+  EXPECT_NE(expected, changed->getValue(17.0f, 0.0f, -5.0f));
+}
+
+TEST(NoiseTest, createKeepsAlgorithm) {
+  for (int algorithm : {Defaults::Perlin, Defaults::RidgedMulti,
+                        Defaults::Billow, Defaults::Random,
+                        Defaults::Mountains}) {
+    std::shared_ptr<const NoiseInterface> noise =
+        NoiseInterface::create(algorithm);
+    std::shared_ptr<const NoiseInterface> changed =
+        noise->withOptions(noise->getOptions());
+    EXPECT_EQ(typeid(*noise), typeid(*changed)) << "Algorithm " << algorithm;
+  }
+}
+
+TEST(NoiseTest, setOptionChecksRange) {
+  NoiseOptions options = PerlinNoise::getDefaultOptions();
+  EXPECT_TRUE(NoiseInterface::setOption("octaves", 30, options));
+  EXPECT_EQ(30, options.octaveCount);
+  EXPECT_TRUE(NoiseInterface::setOption("seed", -4, options));
+  EXPECT_EQ(-4, options.seed);
+  EXPECT_TRUE(NoiseInterface::setOption("frequency", 2.5, options));
+  EXPECT_FLOAT_EQ(2.5f, options.frequency);
+
+  EXPECT_FALSE(NoiseInterface::setOption("octaves", 0, options));
+  EXPECT_FALSE(NoiseInterface::setOption("octaves", 31, options));
+  EXPECT_FALSE(NoiseInterface::setOption("octaves", 2.5, options));
+  EXPECT_FALSE(NoiseInterface::setOption("seed", 1e10, options));
+  EXPECT_FALSE(NoiseInterface::setOption("frequency", 0, options));
+  EXPECT_FALSE(NoiseInterface::setOption(
+      "persistence", std::numeric_limits<double>::quiet_NaN(), options));
+  EXPECT_FALSE(NoiseInterface::setOption("zoom", 1, options));
+  EXPECT_EQ(30, options.octaveCount);
+  EXPECT_EQ(-4, options.seed);
+
+
+  // libnoise accepts the maximum octave count of every algorithm
+  for (int algorithm : {Defaults::Perlin, Defaults::RidgedMulti,
+                        Defaults::Billow, Defaults::Mountains}) {
+    EXPECT_NO_THROW(NoiseInterface::create(algorithm)->withOptions(options))
+        << "Algorithm " << algorithm;
+  }
+}
+
+TEST(NoiseTest, randomIsFunctionOfCoordinates) {
+  RandomNoise noise;
+  float value = noise.getValue(3.0f, 0.0f, -7.0f);
+  EXPECT_EQ(value, noise.getValue(3.0f, 0.0f, -7.0f));
+  EXPECT_EQ(value, RandomNoise().getValue(3.0f, 0.0f, -7.0f));
+  EXPECT_NE(value, noise.getValue(-7.0f, 0.0f, 3.0f));
+}
+
+TEST(NoiseTest, randomDependsOnSeed) {
+  NoiseOptions options = RandomNoise::getDefaultOptions();
+  RandomNoise noise(options);
+  options.seed++;
+  RandomNoise seeded(options);
+
+  int differences = 0;
+  for (int x = 0; x < 100; x++) {
+    differences +=
+        noise.getValue(x, 0.0f, 0.0f) != seeded.getValue(x, 0.0f, 0.0f);
+  }
+  EXPECT_GT(differences, 90);
+}
+
+TEST(NoiseTest, randomNeighbourTilesShareEdge) {
+  // east border of tile 0, 0 is west border of tile 1, 0
+  RandomNoise noise;
+  int width = Defaults::TileWidth + 1;
+  std::vector<float> west(width * width);
+  std::vector<float> east(width * width);
+  noise.fillHeights(0, 0, width, width, width, &west.front());
+  noise.fillHeights(Defaults::TileWidth, 0, width, width, width,
+                    &east.front());
+  for (int row = 0; row < width; row++) {
+    EXPECT_EQ(west[row * width + Defaults::TileWidth], east[row * width])
+        << "Edges differ at row " << row;
+  }
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <noiseGraph.h>
+#include <vector>
+
+// sample coordinates of a grid around the origin, more than one block
+static void samples(std::vector<double> &x, std::vector<double> &z) {
+  x.clear();
+  z.clear();
+  for (int row = -20; row < 20; row++) {
+    for (int column = -15; column < 15; column++) {
+      x.push_back(column * 0.173);
+      z.push_back(row * 0.131);
+    }
+  }
+}
+
+// compiled graph has to give the same values as module at y = 0
+static void expectMatchesModule(const NoiseGraph &graph,
+                                const noise::module::Module &module) {
+  std::vector<double> x, z;
+  samples(x, z);
+  std::vector<double> values(x.size());
+  graph.evaluate(&x.front(), &z.front(), x.size(), &values.front());
+  for (size_t i = 0; i < x.size(); i++) {
+    EXPECT_NEAR(module.GetValue(x[i], 0.0, z[i]), values[i], 1e-12)
+        << "Values differ at x " << x[i] << " z " << z[i];
+  }
+}
+
+TEST(NoiseGraphTest, sourcesMatchLibnoise) {
+  noise::module::Perlin perlin;
+  perlin.SetOctaveCount(4);
+  perlin.SetSeed(3);
+  noise::module::Billow billow;
+  billow.SetFrequency(2.5);
+  noise::module::RidgedMulti ridgedMulti;
+  ridgedMulti.SetLacunarity(1.75);
+
+  NoiseGraph perlinGraph;
+  perlinGraph.compile(perlinGraph.perlin(perlin));
+  expectMatchesModule(perlinGraph, perlin);
+  NoiseGraph billowGraph;
+  billowGraph.compile(billowGraph.billow(billow));
+  expectMatchesModule(billowGraph, billow);
+  NoiseGraph ridgedMultiGraph;
+  ridgedMultiGraph.compile(ridgedMultiGraph.ridgedMulti(ridgedMulti));
+  expectMatchesModule(ridgedMultiGraph, ridgedMulti);
+}
+
+TEST(NoiseGraphTest, modifiersAndCombinersMatchLibnoise) {
+  noise::module::Perlin perlin;
+  noise::module::Billow billow;
+  billow.SetSeed(7);
+  noise::module::RidgedMulti ridgedMulti;
+
+  noise::module::ScaleBias scaleBias;
+  scaleBias.SetSourceModule(0, billow);
+  scaleBias.SetScale(0.5);
+  scaleBias.SetBias(-0.25);
+  noise::module::Abs abs;
+  abs.SetSourceModule(0, perlin);
+  noise::module::Clamp clamp;
+  clamp.SetSourceModule(0, ridgedMulti);
+  clamp.SetBounds(-0.5, 0.5);
+  noise::module::Exponent exponent;
+  exponent.SetSourceModule(0, clamp);
+  exponent.SetExponent(1.5);
+  noise::module::Invert invert;
+  invert.SetSourceModule(0, exponent);
+  noise::module::Add add;
+  add.SetSourceModule(0, scaleBias);
+  add.SetSourceModule(1, abs);
+  noise::module::Multiply multiply;
+  multiply.SetSourceModule(0, add);
+  multiply.SetSourceModule(1, invert);
+  noise::module::Min min;
+  min.SetSourceModule(0, multiply);
+  min.SetSourceModule(1, perlin);
+  noise::module::Max max;
+  max.SetSourceModule(0, invert);
+  max.SetSourceModule(1, billow);
+  noise::module::Blend blend;
+  blend.SetSourceModule(0, min);
+  blend.SetSourceModule(1, max);
+  blend.SetSourceModule(2, perlin);
+  noise::module::Select select;
+  select.SetSourceModule(0, blend);
+  select.SetSourceModule(1, ridgedMulti);
+  select.SetSourceModule(2, billow);
+  select.SetBounds(-0.25, 0.5);
+  select.SetEdgeFalloff(0.2);
+
+  NoiseGraph graph;
+  NoiseGraph::Node perlinNode = graph.perlin(perlin);
+  NoiseGraph::Node billowNode = graph.billow(billow);
+  NoiseGraph::Node ridgedMultiNode = graph.ridgedMulti(ridgedMulti);
+  NoiseGraph::Node invertNode = graph.invert(
+      graph.exponent(graph.clamp(ridgedMultiNode, -0.5, 0.5), 1.5));
+  NoiseGraph::Node addNode = graph.add(graph.scaleBias(billowNode, 0.5, -0.25),
+                                       graph.abs(perlinNode));
+  NoiseGraph::Node blendNode =
+      graph.blend(graph.min(graph.multiply(addNode, invertNode), perlinNode),
+                  graph.max(invertNode, billowNode), perlinNode);
+  graph.compile(graph.select(blendNode, ridgedMultiNode, billowNode, -0.25,
+                             0.5, 0.2));
+
+  // shared nodes are evaluated once
+  EXPECT_EQ(graph.getNodeCount(), graph.getInstructionCount());
+  expectMatchesModule(graph, select);
+
+  // hard edges
+  select.SetEdgeFalloff(0.0);
+  graph.compile(
+      graph.select(blendNode, ridgedMultiNode, billowNode, -0.25, 0.5));
+  expectMatchesModule(graph, select);
+}
+
+TEST(NoiseGraphTest, turbulenceDisplacesSource) {
+  noise::module::Billow billow;
+  NoiseGraph graph;
+  graph.compile(graph.turbulence(graph.billow(billow), 2.0, 0.25, 3, 11));
+
+  noise::module::Perlin xDistort, zDistort;
+  xDistort.SetFrequency(2.0);
+  xDistort.SetOctaveCount(3);
+  xDistort.SetSeed(11);
+  zDistort.SetFrequency(2.0);
+  zDistort.SetOctaveCount(3);
+  zDistort.SetSeed(13);
+
+  std::vector<double> x, z;
+  samples(x, z);
+  for (size_t i = 0; i < x.size(); i += 7) {
+    double displacedX =
+        x[i] + xDistort.GetValue(x[i] + 12414.0 / 65536.0, 0.0,
+                                 z[i] + 31337.0 / 65536.0) *
+                   0.25;
+    double displacedZ =
+        z[i] + zDistort.GetValue(x[i] + 53820.0 / 65536.0, 0.0,
+                                 z[i] + 44845.0 / 65536.0) *
+                   0.25;
+    EXPECT_NEAR(billow.GetValue(displacedX, 0.0, displacedZ),
+                graph.getValue(x[i], z[i]), 1e-12);
+  }
+}
+
+TEST(NoiseGraphTest, sharedNodeIsCompiledForEachDisplacement) {
+  noise::module::Perlin perlin;
+  NoiseGraph graph;
+  NoiseGraph::Node source = graph.perlin(perlin);
+  NoiseGraph::Node turbulence = graph.turbulence(source, 1.0, 0.5, 2, 0);
+  NoiseGraph::Node difference =
+      graph.add(source, graph.invert(turbulence));
+  graph.compile(difference);
+  // source at both coordinates
+  EXPECT_EQ(graph.getNodeCount() + 1, graph.getInstructionCount());
+
+  NoiseGraph displaced;
+  displaced.compile(
+      displaced.turbulence(displaced.perlin(perlin), 1.0, 0.5, 2, 0));
+  for (double x = -2.0; x < 2.0; x += 0.37) {
+    EXPECT_NEAR(perlin.GetValue(x, 0.0, 0.5) - displaced.getValue(x, 0.5),
+                graph.getValue(x, 0.5), 1e-12);
+  }
+}
+
+TEST(NoiseGraphTest, batchMatchesSingleSamples) {
+  noise::module::RidgedMulti ridgedMulti;
+  noise::module::Perlin perlin;
+  NoiseGraph graph;
+  graph.compile(graph.turbulence(
+      graph.blend(graph.ridgedMulti(ridgedMulti), graph.constant(-0.5),
+                  graph.perlin(perlin)),
+      3.0, 0.1, 2, 5));
+
+  std::vector<double> x, z;
+  samples(x, z);
+  std::vector<double> values(x.size());
+  graph.evaluate(&x.front(), &z.front(), x.size(), &values.front());
+  for (size_t i = 0; i < x.size(); i++) {
+    EXPECT_EQ(graph.getValue(x[i], z[i]), values[i])
+        << "Values differ at sample " << i;
+  }
+}
+
+TEST(NoiseGraphTest, unknownNodeIsZero) {
+  NoiseGraph graph;
+  NoiseGraph::Node constant = graph.constant(0.75);
+  graph.compile(graph.add(constant, 42));
+  EXPECT_EQ(0.75, graph.getValue(1.0, 2.0));
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <profiler.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static const char TracePath[] = "testProfiler.json";
+
+TEST(ProfilerTest, recordsNothingWhileDisabled) {
+  Profiler profiler;
+  EXPECT_FALSE(profiler.isEnabled());
+  { ScopedTimer timer("stage", profiler); }
+  profiler.record("other", 0.0, 1000.0);
+  profiler.endFrame();
+  EXPECT_TRUE(profiler.getStages().empty());
+}
+
+TEST(ProfilerTest, sumsDurationsOfFrame) {
+  Profiler profiler;
+  profiler.setEnabled(true);
+  profiler.record("update", 0.0, 1500.0);
+  profiler.record("render", 1500.0, 250.0);
+  profiler.record("update", 2000.0, 500.0);
+  profiler.endFrame();
+
+  std::vector<Profiler::Stage> stages = profiler.getStages();
+  ASSERT_EQ(2u, stages.size());
+  EXPECT_EQ("update", stages[0].name);
+  EXPECT_EQ("render", stages[1].name);
+  EXPECT_EQ(1u, stages[0].offset);
+  EXPECT_FLOAT_EQ(2.0f, stages[0].history[0]);
+  EXPECT_FLOAT_EQ(0.25f, stages[1].history[0]);
+  EXPECT_EQ(Defaults::FrameTimeHistory,
+            static_cast<int>(stages[0].history.size()));
+}
+
+TEST(ProfilerTest, percentilesOfHistory) {
+  Profiler profiler;
+  profiler.setEnabled(true);
+  // one slow frame among fast ones
+  for (int frame = 0; frame < Defaults::FrameTimeHistory; frame++) {
+    profiler.record("stage", 0.0, frame == 7 ? 40000.0 : 1000.0);
+    profiler.endFrame();
+  }
+  Profiler::Stage stage = profiler.getStages()[0];
+  EXPECT_FLOAT_EQ(1.0f, stage.median);
+  EXPECT_FLOAT_EQ(1.0f, stage.p95);
+  EXPECT_FLOAT_EQ(40.0f, stage.maximum);
+}
+
+TEST(ProfilerTest, scopedTimerMeasuresScope) {
+  Profiler profiler;
+  profiler.setEnabled(true);
+  {
+    ScopedTimer timer("sleep", profiler);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  profiler.endFrame();
+  EXPECT_GE(profiler.getStages()[0].history[0], 5.0f);
+}
+
+TEST(ProfilerTest, writesTraceAfterFrames) {
+  Profiler profiler;
+  profiler.setEnabled(true);
+  profiler.nameThread("Main");
+  profiler.startTrace(TracePath, 2);
+  profiler.record("update", 10.0, 20.0);
+  std::thread worker([&profiler]() {
+    ScopedTimer timer("TileGenerator::generate", profiler);
+  });
+  worker.join();
+  profiler.record("GPU render", 15.0, 5.0, Profiler::GpuThread);
+  profiler.endFrame();
+  EXPECT_TRUE(profiler.isTracing());
+  EXPECT_TRUE(profiler.getTracePath().empty());
+  profiler.endFrame();
+  EXPECT_FALSE(profiler.isTracing());
+  EXPECT_EQ(TracePath, profiler.getTracePath());
+
+  std::ifstream file(TracePath);
+  std::stringstream trace;
+  trace << file.rdbuf();
+  std::string json = trace.str();
+  EXPECT_EQ(0u, json.find("{\"traceEvents\": ["));
+  EXPECT_NE(std::string::npos, json.find("\"args\": {\"name\": \"Main\"}"));
+  EXPECT_NE(std::string::npos,
+            json.find("{\"name\": \"update\", \"ph\": \"X\", \"pid\": 1, "
+                      "\"tid\": 1, \"ts\": 10.000, \"dur\": 20.000}"));
+  EXPECT_NE(std::string::npos,
+            json.find("\"name\": \"TileGenerator::generate\", \"ph\": \"X\", "
+                      "\"pid\": 1, \"tid\": 2"));
+  EXPECT_NE(std::string::npos, json.find("\"tid\": 0, \"ts\": 15.000"));
+  file.close();
+  std::remove(TracePath);
+}
@@ -20,9 +20,9 @@ TEST(QuadtreeTest, indicesCountOfMaximumLod) {
 TEST(QuadtreeTest, indicesPositionOfMinimumLod) {
   Quadtree quadtree;
   unsigned int w = Defaults::TileWidth;
-  std::vector<GLuint> expected = {0, w * (w + 1), w * (w + 1) + w, 0,
-                                  w * (w + 1) + w, w};
-  std::vector<GLuint> indices = quadtree.getIndicesOfLevel(0);
+  std::vector<unsigned int> expected = {0, w * (w + 1), w * (w + 1) + w, 0,
+                                        w * (w + 1) + w, w};
+  std::vector<unsigned int> indices = quadtree.getIndicesOfLevel(0);
   for (size_t i = 0; i < expected.size(); i++) {
     EXPECT_EQ(expected[i], indices[i]) << "Vectors differ at index " << i;
   }
@@ -31,7 +31,7 @@ TEST(QuadtreeTest, indicesPositionOfMinimumLod) {
 TEST(QuadtreeTest, indicesPositionOfLod1) {
   Quadtree quadtree;
   unsigned int w = Defaults::TileWidth;
-  std::vector<GLuint> expected = {
+  std::vector<unsigned int> expected = {
       // nw
       0, w * (w + 1) / 2, w * (w + 1) / 2 + w / 2, 0, w * (w + 1) / 2 + w / 2,
       w / 2,
@@ -44,8 +44,63 @@ TEST(QuadtreeTest, indicesPositionOfLod1) {
       // nw
       w / 2, w * (w + 1) / 2 + w / 2, w * (w + 1) / 2 + w, w / 2,
       w * (w + 1) / 2 + w, w};
-  std::vector<GLuint> indices = quadtree.getIndicesOfLevel(1);
+  std::vector<unsigned int> indices = quadtree.getIndicesOfLevel(1);
   for (size_t i = 0; i < expected.size(); i++) {
     EXPECT_EQ(expected[i], indices[i]) << "Vectors differ at index " << i;
   }
 }
+
+TEST(QuadtreeTest, nodeCount) {
+  // 1 + 4 + 16 + ... nodes
+  size_t expected = 0;
+  for (int level = 0; level <= Defaults::MaximumLod; level++) {
+    expected += std::pow(4, level);
+  }
+  EXPECT_EQ(expected, Quadtree::getNodeCount());
+}
+
+TEST(QuadtreeTest, levelOfNode) {
+  EXPECT_EQ(0, Quadtree::getLevelOfNode(0));
+  EXPECT_EQ(1, Quadtree::getLevelOfNode(1));
+  EXPECT_EQ(1, Quadtree::getLevelOfNode(4));
+  EXPECT_EQ(2, Quadtree::getLevelOfNode(5));
+  EXPECT_EQ(Defaults::MaximumLod,
+            Quadtree::getLevelOfNode(Quadtree::getNodeCount() - 1));
+}
+
+TEST(QuadtreeTest, nodeIndicesAreConsecutiveOnDeeperLevel) {
+  Quadtree quadtree;
+  // second child of root covers second quarter of level 2
+  size_t node = Quadtree::getChild(0, 1);
+  IndexSpan nodeIndices = quadtree.getNodeIndices(node, 2);
+  IndexSpan level = quadtree.getLevel(2);
+  ASSERT_EQ(level.size() / 4, nodeIndices.size());
+  EXPECT_EQ(level.begin() + level.size() / 4, nodeIndices.begin());
+}
+
+TEST(QuadtreeTest, nodeGeometry) {
+  Quadtree quadtree;
+  unsigned int w = Defaults::TileWidth;
+  // bottom right child of root
+  size_t node = Quadtree::getChild(0, 2);
+  EXPECT_EQ(w * (w + 1) / 2 + w / 2, quadtree.getNodeStartpoint(node));
+  EXPECT_EQ(w / 2, quadtree.getNodeWidth(node));
+}
+
+TEST(QuadtreeTest, boundsOfNodes) {
+  Quadtree quadtree;
+  unsigned int w = Defaults::TileWidth + 1;
+  // heights rise along x, so each node spans heights of its columns
+  std::vector<float> heights(w * w);
+  for (size_t i = 0; i < heights.size(); i++) {
+    heights[i] = i % w;
+  }
+  std::vector<NodeBounds> bounds = quadtree.calculateBounds(&heights.front());
+  EXPECT_FLOAT_EQ(0.0f, bounds[0].minHeight);
+  EXPECT_FLOAT_EQ(Defaults::TileWidth, bounds[0].maxHeight);
+
+  // top right child spans right half
+  size_t node = Quadtree::getChild(0, 3);
+  EXPECT_FLOAT_EQ(Defaults::TileWidth / 2, bounds[node].minHeight);
+  EXPECT_FLOAT_EQ(Defaults::TileWidth, bounds[node].maxHeight);
+}
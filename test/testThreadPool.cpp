@@ -0,0 +1,26 @@
+#include <gtest/gtest.h>
+#include <threadPool.h>
+#include <future>
+#include <vector>
+
+TEST(ThreadPoolTest, returnsResultOfJob) {
+  ThreadPool pool(2);
+  std::future<int> result = pool.submit([]() { return 6 * 7; });
+  EXPECT_EQ(42, result.get());
+}
+
+TEST(ThreadPoolTest, runsAllJobs) {
+  ThreadPool pool(4);
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; i++) {
+    results.push_back(pool.submit([i]() { return i * i; }));
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(i * i, results[i].get()) << "Wrong result of job " << i;
+  }
+}
+
+TEST(ThreadPoolTest, usesAtLeastOneThread) {
+  ThreadPool pool;
+  EXPECT_GE(pool.getThreadCount(), 1u);
+}
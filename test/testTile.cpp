@@ -26,3 +26,86 @@ TEST(TileTest, indicesFirstTriangle) {
     EXPECT_EQ(expected[i], indices[i]) << "Vectors differ at index " << i;
   }
 }
+
+TEST(TileTest, verticesAreBuiltFromGeneratedHeights) {
+  std::shared_ptr<const NoiseInterface> noise(new PerlinNoise);
+  Tile tile(1, -2, noise);
+  TileData data = TileGenerator::generate(1, -2, noise, Defaults::TileWidth);
+  std::vector<Vertex> vertices = tile.getVertices();
+  ASSERT_EQ(vertices.size(), data.heights.size());
+  size_t width = Defaults::TileWidth + 1;
+  for (size_t i = 0; i < vertices.size(); i++) {
+    // row and column are signed, tile z offset is negative
+    int column = i % width;
+    int row = i / width;
+    glm::vec3 expected(1 * Defaults::TileWidth + column, data.heights[i],
+                       -2 * static_cast<int>(Defaults::TileWidth) + row);
+    EXPECT_EQ(expected, vertices[i].position)
+        << "Vertices differ at index " << i;
+  }
+}
+
+TEST(TileTest, selectLodNearTileIsMaximum) {
+  EXPECT_EQ(Defaults::MaximumLod, Tile::selectLod(0.0f));
+  EXPECT_EQ(Defaults::MaximumLod, Tile::selectLod(Defaults::LodDistance - 1));
+}
+
+TEST(TileTest, selectLodDecreasesWithDistance) {
+  EXPECT_EQ(Defaults::MaximumLod - 1,
+            Tile::selectLod(Defaults::LodDistance * 1.5f));
+  EXPECT_EQ(Defaults::MaximumLod - 2,
+            Tile::selectLod(Defaults::LodDistance * 3.0f));
+  EXPECT_EQ(Defaults::MinimumLod, Tile::selectLod(1e9f));
+}
+
+TEST(TileTest, distanceToTile) {
+  Tile tile(1, 0);
+  NodeBounds bounds = tile.getBounds()[0];
+  float y = (bounds.minHeight + bounds.maxHeight) / 2;
+  // inside of tile bounds
+  glm::vec3 inside(Defaults::TileWidth + 1.0f, y, 1.0f);
+  EXPECT_FLOAT_EQ(0.0f, tile.distanceTo(inside));
+  // west of tile
+  glm::vec3 west(Defaults::TileWidth - 10.0f, y, 1.0f);
+  EXPECT_FLOAT_EQ(10.0f, tile.distanceTo(west));
+}
+
+TEST(TileTest, triangleCountIncludesSkirts) {
+  Tile tile(0, 0);
+  tile.setLod(0);
+  // two grid triangles and two skirt triangles per edge
+  EXPECT_EQ(2u + 4 * 2, tile.getTriangleCount());
+}
+
+TEST(TileTest, boundingBoxCoversSkirts) {
+  Tile tile(1, 0);
+  BoundingBox box = tile.getBoundingBox();
+  NodeBounds bounds = tile.getBounds()[0];
+  float bottom = bounds.minHeight - Defaults::SkirtDepth;
+  EXPECT_EQ(glm::vec3(Defaults::TileWidth, bottom, 0.0f), box.getMinimum());
+  EXPECT_EQ(glm::vec3(2 * Defaults::TileWidth, bounds.maxHeight,
+                      Defaults::TileWidth),
+            box.getMaximum());
+}
+
+TEST(TileTest, previewIsReplacedByTile) {
+  std::shared_ptr<const NoiseInterface> noise(new PerlinNoise);
+  Tile tile(0, 1, noise);
+  NoiseOptions options = noise->getOptions();
+  options.octaveCount = 2;
+  std::shared_ptr<const NoiseInterface> changed = noise->withOptions(options);
+
+  ThreadPool pool(1);
+  tile.requestPreview(changed, pool);
+  tile.requestAlgorithm(changed, pool);
+  EXPECT_TRUE(tile.hasPendingPreview());
+  tile.waitForPendingJob();
+
+  // full tile wins, preview is dropped
+  EXPECT_TRUE(tile.applyFinishedJob());
+  EXPECT_FALSE(tile.hasPendingPreview());
+  EXPECT_FALSE(tile.applyFinishedJob());
+  TileData expected =
+      TileGenerator::generate(0, 1, changed, Defaults::TileWidth);
+  EXPECT_EQ(expected.heights, tile.getHeights());
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <tileBaker.h>
+#include <tileGenerator.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static const char Container[] = "testTileBaker.lltc";
+static const char Directory[] = "testTileBaker";
+
+// heights of a tile differ from generated ones by at most half a step
+static void expectMatchesGenerated(const std::vector<float> &heights,
+                                   const int &x, const int &z) {
+  TileData data = TileGenerator::generate(
+      x, z, NoiseInterface::create(Defaults::Billow), Defaults::TileWidth);
+  ASSERT_EQ(data.heights.size(), heights.size());
+  float step = Defaults::MaxMeshHeight / 0xffff;
+  for (size_t i = 0; i < heights.size(); i++) {
+    float height = std::min(std::max(data.heights[i], 0.0f),
+                            Defaults::MaxMeshHeight);
+    ASSERT_NEAR(height, heights[i], step / 2 + 1e-4f)
+        << "Heights differ at vertex " << i << " of tile " << x << ", " << z;
+  }
+}
+
+TEST(TileBakerTest, quantizeClampsToMaximumHeight) {
+  EXPECT_EQ(0, TileBaker::quantize(-2.0f));
+  EXPECT_EQ(0xffff, TileBaker::quantize(Defaults::MaxMeshHeight + 1.0f));
+  EXPECT_FLOAT_EQ(Defaults::MaxMeshHeight, TileBaker::dequantize(0xffff));
+  EXPECT_NEAR(12.5f, TileBaker::dequantize(TileBaker::quantize(12.5f)),
+              Defaults::MaxMeshHeight / 0xffff);
+}
+
+TEST(TileBakerTest, containerHoldsAllTilesOfRegion) {
+  TileBaker baker(NoiseInterface::create(Defaults::Billow));
+  TileRegion region = {-2, 1, 3, 2};
+  ASSERT_TRUE(baker.bake(region, Container, TileBaker::Container, 2));
+  EXPECT_EQ(6, baker.getTileCount());
+
+  std::vector<float> heights;
+  for (int z = 1; z < 3; z++) {
+    for (int x = -2; x < 1; x++) {
+      ASSERT_TRUE(TileBaker::readTile(Container, x, z, heights));
+      expectMatchesGenerated(heights, x, z);
+    }
+  }
+  EXPECT_FALSE(TileBaker::readTile(Container, 1, 1, heights));
+  EXPECT_FALSE(TileBaker::readTile(Container, -2, 0, heights));
+  std::remove(Container);
+}
+
+TEST(TileBakerTest, rawWritesFilePerTile) {
+  TileBaker baker(NoiseInterface::create(Defaults::Billow));
+  TileRegion region = {4, -1, 2, 2};
+  ASSERT_TRUE(baker.bake(region, Directory, TileBaker::Raw));
+
+  size_t width = Defaults::TileWidth + 1;
+  for (int z = -1; z < 1; z++) {
+    for (int x = 4; x < 6; x++) {
+      std::string path = std::string(Directory) + "/tile_" +
+                         std::to_string(x) + "_" + std::to_string(z) + ".r16";
+      std::ifstream file(path, std::ios::binary);
+      std::vector<uint16_t> values(width * width);
+      file.read(reinterpret_cast<char *>(&values.front()),
+                values.size() * sizeof(uint16_t));
+      ASSERT_TRUE(file.good()) << "Can't read " << path;
+      EXPECT_EQ(EOF, file.peek());
+      std::vector<float> heights;
+      for (uint16_t value : values) {
+        heights.push_back(TileBaker::dequantize(value));
+      }
+      expectMatchesGenerated(heights, x, z);
+      file.close();
+      std::remove(path.c_str());
+    }
+  }
+  std::remove((std::string(Directory) + "/region").c_str());
+  std::remove(Directory);
+}
+
+TEST(TileBakerTest, emptyRegionFails) {
+  TileBaker baker(NoiseInterface::create(Defaults::Perlin));
+  TileRegion region = {0, 0, 0, 4};
+  EXPECT_FALSE(baker.bake(region, Container, TileBaker::Container));
+  EXPECT_EQ(0, baker.getTileCount());
+}
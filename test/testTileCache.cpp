@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <tileCache.h>
+#include <memory>
+#include <vector>
+
+// tile of x, z with count heights filled with value
+static TileData tileData(const int &x, const int &z, const float &value,
+                         const size_t &count = 10) {
+  TileData data;
+  data.x = x;
+  data.z = z;
+  data.heights = std::vector<float>(count, value);
+  return data;
+}
+
+TEST(TileCacheTest, findsInsertedTile) {
+  TileCache cache;
+  PerlinNoise noise;
+  TileData data;
+  EXPECT_FALSE(cache.find(TileKey(noise, 1, 2), 10, data));
+
+  cache.insert(TileKey(noise, 1, 2), tileData(1, 2, 3.0f));
+  ASSERT_TRUE(cache.find(TileKey(noise, 1, 2), 10, data));
+  EXPECT_EQ(1, data.x);
+  EXPECT_EQ(2, data.z);
+  EXPECT_EQ(std::vector<float>(10, 3.0f), data.heights);
+  EXPECT_EQ(1u, cache.getHits());
+  EXPECT_EQ(1u, cache.getMisses());
+}
+
+TEST(TileCacheTest, otherCountMisses) {
+  TileCache cache;
+  PerlinNoise noise;
+  cache.insert(TileKey(noise, 0, 0), tileData(0, 0, 1.0f));
+
+  TileData data = tileData(5, 5, 2.0f, 3);
+  EXPECT_FALSE(cache.find(TileKey(noise, 0, 0), 81, data));
+  EXPECT_EQ(5, data.x);
+  EXPECT_EQ(std::vector<float>(3, 2.0f), data.heights);
+  EXPECT_EQ(0u, cache.getHits());
+  EXPECT_EQ(1u, cache.getMisses());
+}
+
+TEST(TileCacheTest, keyContainsAlgorithmAndOptions) {
+  TileCache cache;
+  PerlinNoise noise;
+  cache.insert(TileKey(noise, 0, 0), tileData(0, 0, 1.0f));
+
+  TileData data;
+  EXPECT_FALSE(cache.find(TileKey(BillowNoise(), 0, 0), 10, data));
+  NoiseOptions options = noise.getOptions();
+  options.frequency *= 2;
+  EXPECT_FALSE(cache.find(TileKey(PerlinNoise(options), 0, 0), 10, data));
+  EXPECT_TRUE(cache.find(TileKey(PerlinNoise(), 0, 0), 10, data));
+}
+
+TEST(TileCacheTest, dropsLeastRecentlyUsed) {
+  // room for two tiles of 10 heights
+  const size_t tileBytes = 10 * sizeof(float);
+  TileCache cache(2 * tileBytes);
+  RandomNoise noise;
+  TileData data;
+  cache.insert(TileKey(noise, 0, 0), tileData(0, 0, 0.0f));
+  cache.insert(TileKey(noise, 1, 0), tileData(1, 0, 1.0f));
+  // 0, 0 is used more recently than 1, 0
+  ASSERT_TRUE(cache.find(TileKey(noise, 0, 0), 10, data));
+  cache.insert(TileKey(noise, 2, 0), tileData(2, 0, 2.0f));
+
+  EXPECT_EQ(2u, cache.getSize());
+  EXPECT_EQ(2 * tileBytes, cache.getBytes());
+  EXPECT_TRUE(cache.find(TileKey(noise, 0, 0), 10, data));
+  EXPECT_FALSE(cache.find(TileKey(noise, 1, 0), 10, data));
+  EXPECT_TRUE(cache.find(TileKey(noise, 2, 0), 10, data));
+
+  cache.setMaximumBytes(tileBytes);
+  EXPECT_EQ(1u, cache.getSize());
+  EXPECT_EQ(tileBytes, cache.getBytes());
+  EXPECT_TRUE(cache.find(TileKey(noise, 2, 0), 10, data));
+}
+
+TEST(TileCacheTest, countsHeightsAndBounds) {
+  TileCache cache;
+  RandomNoise noise;
+  TileData data = tileData(0, 0, 1.0f);
+  data.bounds.resize(5);
+  cache.insert(TileKey(noise, 0, 0), data);
+  EXPECT_EQ(10 * sizeof(float) + 5 * sizeof(NodeBounds), cache.getBytes());
+
+  // replaced tile isn't counted twice
+  cache.insert(TileKey(noise, 0, 0), tileData(0, 0, 2.0f));
+  EXPECT_EQ(10 * sizeof(float), cache.getBytes());
+  cache.clear();
+  EXPECT_EQ(0u, cache.getBytes());
+}
+
+TEST(TileCacheTest, generateUsesCache) {
+  TileCache cache;
+  std::shared_ptr<const NoiseInterface> noise(new RidgedMultiNoise);
+  TileData generated = TileGenerator::generate(
+      -1, 3, noise, Defaults::TileWidth, nullptr, &cache);
+  EXPECT_EQ(1u, cache.getMisses());
+  TileData cached = TileGenerator::generate(-1, 3, noise, Defaults::TileWidth,
+                                            nullptr, &cache);
+  EXPECT_EQ(1u, cache.getHits());
+
+  EXPECT_EQ(-1, cached.x);
+  EXPECT_EQ(3, cached.z);
+  EXPECT_EQ(generated.heights, cached.heights);
+  ASSERT_EQ(generated.bounds.size(), cached.bounds.size());
+  for (size_t i = 0; i < generated.bounds.size(); i++) {
+    EXPECT_EQ(generated.bounds[i].minHeight, cached.bounds[i].minHeight);
+    EXPECT_EQ(generated.bounds[i].maxHeight, cached.bounds[i].maxHeight);
+  }
+}
+
+// random noise counting evaluated samples
+class CountingNoise : public RandomNoise {
+ public:
+  mutable int samples = 0;
+
+  void fillHeights(const int &xOffset, const int &zOffset, const int &columns,
+                   const int &rows, const int &stride, float *out) const {
+    samples += columns * rows;
+    RandomNoise::fillHeights(xOffset, zOffset, columns, rows, stride, out);
+  }
+};
+
+TEST(TileCacheTest, generateCopiesEdgesOfNeighbours) {
+  TileCache cache;
+  std::shared_ptr<CountingNoise> noise(new CountingNoise);
+  int width = Defaults::TileWidth + 1;
+  // west and north neighbour of tile 1, 1
+  TileGenerator::generate(0, 1, noise, Defaults::TileWidth, nullptr, &cache);
+  TileGenerator::generate(1, 0, noise, Defaults::TileWidth, nullptr, &cache);
+  noise->samples = 0;
+
+  TileData data = TileGenerator::generate(1, 1, noise, Defaults::TileWidth,
+                                          nullptr, &cache);
+  EXPECT_EQ((width - 1) * (width - 1), noise->samples);
+  TileData expected = TileGenerator::generate(1, 1, noise, Defaults::TileWidth);
+  EXPECT_EQ(expected.heights, data.heights);
+}
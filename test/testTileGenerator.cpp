@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <threadPool.h>
+#include <tileGenerator.h>
+#include <future>
+#include <memory>
+#include <vector>
+
+TEST(TileGeneratorTest, concurrentGenerationIsDeterministic) {
+  // all algorithms share one generator between worker threads
+  ThreadPool pool(4);
+  for (int algorithm : {Defaults::Perlin, Defaults::RidgedMulti,
+                        Defaults::Billow, Defaults::Random}) {
+    std::shared_ptr<const NoiseInterface> noise =
+        NoiseInterface::create(algorithm);
+    TileData expected =
+        TileGenerator::generate(2, -1, noise, Defaults::TileWidth);
+
+    std::vector<std::future<TileData>> jobs;
+    for (int i = 0; i < 8; i++) {
+      jobs.push_back(pool.submit([noise]() {
+        return TileGenerator::generate(2, -1, noise, Defaults::TileWidth);
+      }));
+    }
+    for (auto &job : jobs) {
+      EXPECT_EQ(expected.heights, job.get().heights) << "Algorithm "
+                                                     << algorithm;
+    }
+  }
+}
+
+TEST(TileGeneratorTest, previewMatchesTileAtSamples) {
+  std::shared_ptr<const NoiseInterface> noise(new BillowNoise);
+  TileData full = TileGenerator::generate(-1, 2, noise, Defaults::TileWidth);
+  TileData preview =
+      TileGenerator::generatePreview(-1, 2, noise, Defaults::TileWidth);
+  ASSERT_EQ(full.heights.size(), preview.heights.size());
+  EXPECT_EQ(full.bounds.size(), preview.bounds.size());
+
+  int width = Defaults::TileWidth + 1;
+  for (int z = 0; z < width; z += Defaults::PreviewStep) {
+    for (int x = 0; x < width; x += Defaults::PreviewStep) {
+      EXPECT_FLOAT_EQ(full.heights[z * width + x],
+                      preview.heights[z * width + x])
+          << "Heights differ at x " << x << " z " << z;
+    }
+  }
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <tileGrid.h>
+#include <set>
+#include <vector>
+
+// slots of all tiles of grid, each slot exactly once
+static void expectAllSlots(const TileGrid &grid) {
+  std::set<size_t> slots;
+  for (const TileCoordinates &tile : grid.getTiles()) {
+    size_t slot = grid.slot(tile.x, tile.z);
+    EXPECT_LT(slot, grid.getSlotCount());
+    EXPECT_TRUE(slots.insert(slot).second)
+        << "Slot " << slot << " used twice, tile " << tile.x << "," << tile.z;
+  }
+  EXPECT_EQ(grid.getSlotCount(), slots.size());
+}
+
+TEST(TileGridTest, slotOfNegativeCoordinates) {
+  TileGrid grid(1);
+  EXPECT_EQ(3, grid.getSize());
+  EXPECT_EQ(0u, grid.slot(0, 0));
+  EXPECT_EQ(2u, grid.slot(-1, 0));
+  EXPECT_EQ(2u, grid.slot(2, 0));
+  EXPECT_EQ(1u, grid.slot(-2, 0));
+  EXPECT_EQ(0u, grid.slot(-3, -3));
+  EXPECT_EQ(2u * 3 + 2, grid.slot(-4, -1));
+  EXPECT_EQ(1u * 3 + 1, grid.slot(-5, -8));
+}
+
+TEST(TileGridTest, slotsAreUniqueAroundAnyCenter) {
+  for (int radius = 0; radius <= 3; radius++) {
+    for (int center : {-7, -1, 0, 1, 6}) {
+      expectAllSlots(TileGrid(radius, center, -center));
+    }
+  }
+}
+
+TEST(TileGridTest, exposesColumnWhenMovingEast) {
+  TileGrid grid(2, -1, 4);
+  std::vector<TileCoordinates> exposed = grid.moveTo(0, 4);
+  ASSERT_EQ(5u, exposed.size());
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(2, exposed[i].x);
+    EXPECT_EQ(2 + i, exposed[i].z) << "Tiles not row by row";
+  }
+  EXPECT_EQ(0, grid.getCenterX());
+  EXPECT_TRUE(grid.moveTo(0, 4).empty());
+}
+
+TEST(TileGridTest, exposesAllTilesAfterJump) {
+  TileGrid grid(1);
+  std::vector<TileCoordinates> exposed = grid.moveTo(-10, 3);
+  ASSERT_EQ(9u, exposed.size());
+  EXPECT_EQ(-11, exposed.front().x);
+  EXPECT_EQ(2, exposed.front().z);
+  EXPECT_EQ(-9, exposed.back().x);
+  EXPECT_EQ(4, exposed.back().z);
+}
+
+TEST(TileGridTest, exposedTilesTakeSlotsOfLeavingTiles) {
+  // moves in all directions, also across the origin
+  const int moves[][2] = {{1, 0},  {0, 1},  {-1, -1}, {2, -1},
+                          {-3, 2}, {-1, 0}, {4, 4},   {-6, -5}};
+  TileGrid grid(2, 1, 1);
+  for (const auto &move : moves) {
+    TileGrid old = grid;
+    int x = grid.getCenterX() + move[0];
+    int z = grid.getCenterZ() + move[1];
+    std::vector<TileCoordinates> exposed = grid.moveTo(x, z);
+
+    // same tiles as comparing both grids tile by tile
+    std::set<size_t> leaving;
+    for (const TileCoordinates &tile : old.getTiles()) {
+      if (!grid.contains(tile.x, tile.z)) {
+        leaving.insert(old.slot(tile.x, tile.z));
+      }
+    }
+    std::set<size_t> taken;
+    for (const TileCoordinates &tile : exposed) {
+      EXPECT_TRUE(grid.contains(tile.x, tile.z));
+      EXPECT_FALSE(old.contains(tile.x, tile.z))
+          << "Tile " << tile.x << "," << tile.z << " was already visible";
+      taken.insert(grid.slot(tile.x, tile.z));
+    }
+    EXPECT_EQ(leaving.size(), exposed.size());
+    EXPECT_EQ(leaving, taken) << "Move to " << x << "," << z;
+    expectAllSlots(grid);
+  }
+}
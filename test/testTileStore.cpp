@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include <tileGenerator.h>
+#include <tileStore.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char Directory[] = "testTileStore";
+
+// store in empty test directory
+class TileStoreTest : public ::testing::Test {
+ protected:
+  TileStore store;
+  PerlinNoise noise;
+
+  virtual void SetUp() {
+    store.open(Directory, 1024 * 1024);
+    store.clear();
+  }
+
+  virtual void TearDown() {
+    store.clear();
+    store.close();
+    std::remove((std::string(Directory) + "/index").c_str());
+    std::remove(Directory);
+  }
+
+  std::vector<float> heights(const int &count, const float &offset) {
+    std::vector<float> heights(count);
+    for (int i = 0; i < count; i++) {
+      heights[i] = offset + 0.37f * i;
+    }
+    return heights;
+  }
+};
+
+TEST(TileStoreQuantizeTest, roundTripWithinStep) {
+  std::vector<float> heights = {-3.0f, 0.0f, 1.5f, 7.25f, 28.0f};
+  float minimum = 0.0f;
+  float scale = 0.0f;
+  std::vector<uint16_t> values;
+  TileStore::quantize(heights, minimum, scale, values);
+
+  std::vector<float> result;
+  TileStore::dequantize(&values.front(), values.size(), minimum, scale, result);
+  ASSERT_EQ(heights.size(), result.size());
+  EXPECT_FLOAT_EQ(heights.front(), result.front());
+  EXPECT_NEAR(heights.back(), result.back(), scale);
+  for (size_t i = 0; i < heights.size(); i++) {
+    EXPECT_NEAR(heights[i], result[i], scale / 2 + 1e-5f) << "Index " << i;
+  }
+}
+
+TEST(TileStoreQuantizeTest, flatTile) {
+  std::vector<float> heights(10, 4.0f);
+  float minimum = 0.0f;
+  float scale = 0.0f;
+  std::vector<uint16_t> values;
+  TileStore::quantize(heights, minimum, scale, values);
+
+  std::vector<float> result;
+  TileStore::dequantize(&values.front(), values.size(), minimum, scale, result);
+  EXPECT_EQ(heights, result);
+}
+
+TEST_F(TileStoreTest, loadsSavedTile) {
+  TileKey key(noise, 3, -4);
+  std::vector<float> saved = heights(100, -2.0f);
+  std::vector<float> loaded;
+  EXPECT_FALSE(store.load(key, saved.size(), loaded));
+  store.save(key, saved);
+  ASSERT_TRUE(store.load(key, saved.size(), loaded));
+  ASSERT_EQ(saved.size(), loaded.size());
+  for (size_t i = 0; i < saved.size(); i++) {
+    EXPECT_NEAR(saved[i], loaded[i], 1e-3f) << "Index " << i;
+  }
+  EXPECT_EQ(1u, store.getHits());
+  EXPECT_EQ(1u, store.getMisses());
+  EXPECT_EQ(1u, store.getTileCount());
+}
+
+TEST_F(TileStoreTest, otherKeysMiss) {
+  store.save(TileKey(noise, 0, 0), heights(100, 0.0f));
+  std::vector<float> loaded;
+  EXPECT_FALSE(store.load(TileKey(noise, 0, 1), 100, loaded));
+  EXPECT_FALSE(store.load(TileKey(RidgedMultiNoise(), 0, 0), 100, loaded));
+  NoiseOptions options = noise.getOptions();
+  options.seed++;
+  EXPECT_FALSE(store.load(TileKey(PerlinNoise(options), 0, 0), 100, loaded));
+  // different tile width
+  EXPECT_FALSE(store.load(TileKey(noise, 0, 0), 81, loaded));
+}
+
+TEST_F(TileStoreTest, evictsLeastRecentlyUsed) {
+  // limit fits two tiles
+  std::vector<float> saved = heights(1000, 0.0f);
+  store.save(TileKey(noise, 0, 0), saved);
+  size_t tileBytes = store.getBytes();
+  store.open(Directory, 2 * tileBytes);
+  std::vector<float> loaded;
+
+  store.save(TileKey(noise, 1, 0), saved);
+  // 0, 0 is used more recently than 1, 0
+  ASSERT_TRUE(store.load(TileKey(noise, 0, 0), saved.size(), loaded));
+  store.save(TileKey(noise, 2, 0), saved);
+
+  EXPECT_EQ(2u, store.getTileCount());
+  EXPECT_EQ(2 * tileBytes, store.getBytes());
+  EXPECT_TRUE(store.load(TileKey(noise, 0, 0), saved.size(), loaded));
+  EXPECT_FALSE(store.load(TileKey(noise, 1, 0), saved.size(), loaded));
+  EXPECT_TRUE(store.load(TileKey(noise, 2, 0), saved.size(), loaded));
+}
+
+TEST_F(TileStoreTest, keepsTilesAfterReopen) {
+  std::vector<float> saved = heights(100, 1.0f);
+  store.save(TileKey(noise, 5, 5), saved);
+  size_t bytes = store.getBytes();
+  store.close();
+
+  store.open(Directory, 1024 * 1024);
+  EXPECT_EQ(bytes, store.getBytes());
+  std::vector<float> loaded;
+  EXPECT_TRUE(store.load(TileKey(noise, 5, 5), saved.size(), loaded));
+}
+
+// file of key in test directory
+static std::string tilePath(const TileKey &key) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.tile",
+                static_cast<unsigned long long>(key.hash()));
+  return std::string(Directory) + "/" + name;
+}
+
+TEST_F(TileStoreTest, findsTilesMissingFromIndex) {
+  // session ended without close(): no index, temporary file of a save
+  std::vector<float> saved = heights(100, 1.0f);
+  store.save(TileKey(noise, 7, 7), saved);
+  size_t bytes = store.getBytes();
+  store.close();
+  std::remove((std::string(Directory) + "/index").c_str());
+  std::string temporary = tilePath(TileKey(noise, 8, 8)) + ".0.tmp";
+  std::ofstream(temporary) << "partial";
+
+  store.open(Directory, 1024 * 1024);
+  EXPECT_EQ(1u, store.getTileCount());
+  EXPECT_EQ(bytes, store.getBytes());
+  EXPECT_FALSE(std::ifstream(temporary).good());
+  std::vector<float> loaded;
+  EXPECT_TRUE(store.load(TileKey(noise, 7, 7), saved.size(), loaded));
+}
+
+TEST_F(TileStoreTest, dropsTilesWithoutFile) {
+  std::vector<float> saved = heights(100, 1.0f);
+  store.save(TileKey(noise, 1, 1), saved);
+  store.save(TileKey(noise, 2, 2), saved);
+  size_t bytes = store.getBytes();
+  std::remove(tilePath(TileKey(noise, 1, 1)).c_str());
+
+  std::vector<float> loaded;
+  EXPECT_FALSE(store.load(TileKey(noise, 1, 1), saved.size(), loaded));
+  EXPECT_EQ(1u, store.getTileCount());
+  EXPECT_EQ(bytes / 2, store.getBytes());
+
+  // also when reopened with index naming it
+  store.close();
+  std::remove(tilePath(TileKey(noise, 2, 2)).c_str());
+  store.open(Directory, 1024 * 1024);
+  EXPECT_EQ(0u, store.getTileCount());
+  EXPECT_EQ(0u, store.getBytes());
+}
+
+TEST_F(TileStoreTest, concurrentSaves) {
+  // same tile by all threads and a tile per thread
+  std::vector<float> saved = heights(100, 1.0f);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.push_back(std::thread([this, i, &saved]() {
+      store.save(TileKey(noise, 0, 0), saved);
+      store.save(TileKey(noise, i + 1, 0), saved);
+    }));
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(9u, store.getTileCount());
+  std::vector<float> loaded;
+  for (int x = 0; x < 9; x++) {
+    EXPECT_TRUE(store.load(TileKey(noise, x, 0), saved.size(), loaded))
+        << "Tile " << x;
+  }
+}
+
+TEST_F(TileStoreTest, generateUsesStore) {
+  std::shared_ptr<const NoiseInterface> perlin(new PerlinNoise);
+  TileData generated =
+      TileGenerator::generate(1, 2, perlin, Defaults::TileWidth, &store);
+  EXPECT_EQ(1u, store.getMisses());
+  TileData loaded =
+      TileGenerator::generate(1, 2, perlin, Defaults::TileWidth, &store);
+  EXPECT_EQ(1u, store.getHits());
+
+  ASSERT_EQ(generated.heights.size(), loaded.heights.size());
+  for (size_t i = 0; i < generated.heights.size(); i++) {
+    EXPECT_NEAR(generated.heights[i], loaded.heights[i],
+                Defaults::MaxMeshHeight / 65535.0f)
+        << "Index " << i;
+  }
+  EXPECT_EQ(generated.bounds.size(), loaded.bounds.size());
+}